@@ -0,0 +1,369 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <variant>
+#include <parallel_algorithm/thread_pool.h>
+
+/*
+C++20协程支持：task<T>、在线程池上恢复协程的执行器接口，以及从普通代码启动/等待协程的辅助函数。
+- task<T>是惰性协程：创建时不执行，被co_await时才开始，结束后通过对称转移直接恢复等待者；
+  协程体中的异常在co_await处重新抛出。
+- co_await schedule_on(pool)把当前协程转移到线程池上继续执行；spawn(pool, task)在线程池上启动协程并返回future；
+  sync_wait(task)在当前线程启动协程并阻塞等待结果（只用于协程世界的入口，例如main或测试）。
+- 各线程安全队列的async_pop/async_push等待时挂起协程而不占用线程，条件满足时通过resume_on在指定线程池上恢复，
+  因此成千上万个逻辑消费者可以共享少量线程。
+- run_async(pool, f)立即在线程池上开始执行f，返回async_result：普通代码用get()阻塞等待，协程中co_await挂起等待，
+  完成后在执行f的线程上恢复，调用者在此期间可以做其他事（例如I/O）。
+*/
+template <typename T = void>
+class task;
+
+namespace coro_detail
+{
+    struct promise_base
+    {
+        std::coroutine_handle<> continuation;  // co_await本任务的协程
+        std::exception_ptr error;
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct final_awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept
+            {
+                std::coroutine_handle<> next = self.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        final_awaiter final_suspend() noexcept { return {}; }
+
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    template <typename T>
+    struct task_promise : promise_base
+    {
+        std::optional<T> value;
+
+        task<T> get_return_object() noexcept;
+
+        template <typename U>
+        void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+        T result()
+        {
+            if (error) std::rethrow_exception(error);
+            return std::move(*value);
+        }
+    };
+
+    template <>
+    struct task_promise<void> : promise_base
+    {
+        task<void> get_return_object() noexcept;
+
+        void return_void() noexcept {}
+
+        void result()
+        {
+            if (error) std::rethrow_exception(error);
+        }
+    };
+
+    // 启动后自行运行至结束并销毁的协程，用于从普通代码启动task
+    struct detached
+    {
+        struct promise_type
+        {
+            detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+}
+
+template <typename T>
+class task
+{
+public:
+    using promise_type = coro_detail::task_promise<T>;
+
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    task(task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    task& operator=(task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    // 未执行或已结束的任务随对象销毁；不要销毁正挂起在队列等待中的任务
+    ~task()
+    {
+        if (handle_) handle_.destroy();
+    }
+
+    bool done() const noexcept { return !handle_ || handle_.done(); }
+
+    auto operator co_await() const& noexcept { return awaiter{ handle_ }; }
+    auto operator co_await() && noexcept { return awaiter{ handle_ }; }
+
+private:
+    struct awaiter
+    {
+        std::coroutine_handle<promise_type> handle;
+
+        bool await_ready() const noexcept { return !handle || handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> waiting) noexcept
+        {
+            handle.promise().continuation = waiting;
+            return handle;  // 对称转移：直接开始执行本任务
+        }
+
+        T await_resume() { return handle.promise().result(); }
+    };
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace coro_detail
+{
+    template <typename T>
+    task<T> task_promise<T>::get_return_object() noexcept
+    {
+        return task<T>{ std::coroutine_handle<task_promise<T>>::from_promise(*this) };
+    }
+
+    inline task<void> task_promise<void>::get_return_object() noexcept
+    {
+        return task<void>{ std::coroutine_handle<task_promise<void>>::from_promise(*this) };
+    }
+}
+
+// 在executor上恢复协程（没有工作线程的线程池在当前线程直接恢复）；executor为nullptr时在当前线程恢复
+inline void resume_on(ThreadPool* executor, std::coroutine_handle<> handle)
+{
+    if (executor != nullptr)
+    {
+        executor->post([handle] { handle.resume(); });
+    }
+    else
+    {
+        handle.resume();
+    }
+}
+
+// co_await schedule_on(pool)：把当前协程转移到线程池上继续执行
+inline auto schedule_on(ThreadPool& pool) noexcept
+{
+    struct awaiter
+    {
+        ThreadPool& pool;
+
+        bool await_ready() const noexcept { return pool.size() == 0; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            pool.post([handle] { handle.resume(); });
+        }
+
+        void await_resume() const noexcept {}
+    };
+    return awaiter{ pool };
+}
+
+namespace coro_detail
+{
+    // 执行任务并把结果或异常写入promise；executor非空时先转移到该线程池
+    template <typename T>
+    detached complete(ThreadPool* executor, task<T> work, std::promise<T> result)
+    {
+        if (executor != nullptr)
+        {
+            co_await schedule_on(*executor);
+        }
+        try
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                co_await std::move(work);
+                result.set_value();
+            }
+            else
+            {
+                result.set_value(co_await std::move(work));
+            }
+        }
+        catch (...)
+        {
+            result.set_exception(std::current_exception());
+        }
+    }
+}
+
+// 在线程池上启动协程，通过future获取结果或异常
+template <typename T>
+std::future<T> spawn(ThreadPool& pool, task<T> work)
+{
+    std::promise<T> result;
+    std::future<T> future = result.get_future();
+    coro_detail::complete(&pool, std::move(work), std::move(result));
+    return future;
+}
+
+// 在当前线程启动协程并阻塞等待结果；协程挂起后由其他线程恢复并完成
+template <typename T>
+T sync_wait(task<T> work)
+{
+    std::promise<T> result;
+    std::future<T> future = result.get_future();
+    coro_detail::complete(nullptr, std::move(work), std::move(result));
+    return future.get();
+}
+
+// 已在线程池上开始执行的操作的结果：get()阻塞等待，或在协程中co_await（挂起而不占用线程）；
+// 结果只能取一次，同一时刻只能有一个协程等待
+template <typename T>
+class async_result
+{
+private:
+    using value_type = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    struct state
+    {
+        std::mutex mutex;
+        std::condition_variable ready_cv;
+        bool ready = false;
+        std::optional<value_type> value;
+        std::exception_ptr error;
+        std::coroutine_handle<> waiter;  // co_await本结果的协程
+    };
+
+    std::shared_ptr<state> state_;
+
+    template <typename F>
+    friend auto run_async(ThreadPool& pool, F func) -> async_result<std::invoke_result_t<F&>>;
+
+    explicit async_result(std::shared_ptr<state> shared) : state_(std::move(shared)) {}
+
+    // 执行func并保存结果或异常，然后唤醒阻塞的等待者或在当前线程恢复挂起的协程
+    template <typename F>
+    static void complete(state& shared, F& func)
+    {
+        try
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                func();
+                shared.value.emplace();
+            }
+            else
+            {
+                shared.value.emplace(func());
+            }
+        }
+        catch (...)
+        {
+            shared.error = std::current_exception();
+        }
+        std::coroutine_handle<> waiter;
+        {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.ready = true;
+            waiter = std::exchange(shared.waiter, {});
+        }
+        shared.ready_cv.notify_all();
+        if (waiter)
+        {
+            waiter.resume();
+        }
+    }
+
+public:
+    async_result(async_result&&) noexcept = default;
+    async_result& operator=(async_result&&) noexcept = default;
+
+    bool ready() const
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->ready;
+    }
+
+    void wait() const
+    {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->ready_cv.wait(lock, [this] { return state_->ready; });
+    }
+
+    T get()
+    {
+        wait();
+        if (state_->error)
+        {
+            std::rethrow_exception(state_->error);
+        }
+        if constexpr (!std::is_void_v<T>)
+        {
+            return std::move(*state_->value);
+        }
+    }
+
+    auto operator co_await() noexcept
+    {
+        struct awaiter
+        {
+            async_result& result;
+
+            bool await_ready() const { return result.ready(); }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                std::lock_guard<std::mutex> lock(result.state_->mutex);
+                if (result.state_->ready)
+                {
+                    return false;  // 判断与挂起之间已完成，不挂起
+                }
+                result.state_->waiter = handle;
+                return true;
+            }
+
+            T await_resume() { return result.get(); }
+        };
+        return awaiter{ *this };
+    }
+};
+
+// 立即在线程池上执行func，返回可阻塞等待或co_await的结果（没有工作线程的线程池在当前线程执行完毕后返回）
+template <typename F>
+auto run_async(ThreadPool& pool, F func) -> async_result<std::invoke_result_t<F&>>
+{
+    using R = std::invoke_result_t<F&>;
+    using result_type = async_result<R>;
+    auto shared = std::make_shared<typename result_type::state>();
+    pool.post([shared, func = std::move(func)]() mutable { result_type::complete(*shared, func); });
+    return result_type(std::move(shared));
+}
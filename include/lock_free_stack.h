@@ -0,0 +1,442 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+#include <thread>
+#include <random>
+#include <bit>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "threadsafestack.h"
+
+/*
+无锁栈（Treiber栈），接口与thread_safe_stack一致，可直接替换，出队不分配shared_ptr。
+- ABA防护：节点存放在只增不减的节点池中，用32位下标引用；栈顶是一个64位原子量，高32位为版本号，
+  每次修改栈顶版本号加一，普通的64位CAS即可实现带标记的指针，不依赖双字CAS。
+- 安全回收：出栈的节点回收到池内的空闲链表中复用，直到栈析构才释放内存，
+  因此并发线程读取已出栈节点的next不会访问已释放的内存，版本号保证这种过期读取的CAS一定失败。
+- 消除退避：栈顶CAS失败（说明存在竞争）时，线程到随机的消除槽位中尝试与相反操作配对，
+  一次push与一次pop直接在槽位中交换节点后互相抵消，不再访问栈顶，竞争激烈时显著减少栈顶上的冲突。
+- 批量操作：push_range在私有链上构造好全部节点后一次CAS接入，pop_all一次CAS取下整条链。
+适用于LIFO的空闲链表、撤销日志等场景。
+*/
+template <typename T>
+class lock_free_stack
+{
+private:
+    static constexpr std::uint32_t kNull = UINT32_MAX;
+    static constexpr std::size_t kFirstSegment = 64;   // 第一段节点数，之后每段翻倍
+    static constexpr std::size_t kMaxSegments = 26;    // 总容量约 64 * 2^26 个节点
+    static constexpr int kEliminationSpins = 128;      // push在消除槽位上等待配对的轮数
+
+    struct Node
+    {
+        std::atomic<std::uint32_t> next{ kNull };
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    // 带版本号的栈顶：低32位为节点下标，高32位为版本号
+    static constexpr std::uint64_t pack(std::uint32_t index, std::uint32_t tag) noexcept
+    {
+        return (static_cast<std::uint64_t>(tag) << 32) | index;
+    }
+    static constexpr std::uint32_t index_of(std::uint64_t head) noexcept { return static_cast<std::uint32_t>(head); }
+    static constexpr std::uint32_t tag_of(std::uint64_t head) noexcept { return static_cast<std::uint32_t>(head >> 32); }
+
+    // 消除槽位：保存等待配对的push节点下标，kNull表示空闲；每个槽位独占一个缓存行
+    struct alignas(64) EliminationSlot
+    {
+        std::atomic<std::uint32_t> node{ kNull };
+    };
+
+    alignas(64) std::atomic<std::uint64_t> head_{ pack(kNull, 0) };   // 栈顶
+    alignas(64) std::atomic<std::uint64_t> free_{ pack(kNull, 0) };   // 空闲节点链表
+    std::atomic<std::uint32_t> next_fresh_{ 0 };                       // 尚未使用过的下一个节点下标
+    std::atomic<Node*> segments_[kMaxSegments] = {};                   // 节点池分段，按需分配
+    std::unique_ptr<EliminationSlot[]> elimination_;
+    std::size_t elimination_size_;
+
+public:
+    // pop_all取下的整条链，接口与std::stack一致（top/pop/empty），按原栈的出栈顺序访问；
+    // 析构时销毁剩余元素并把节点还给所属的栈，因此不能比所属的栈活得更久
+    class batch
+    {
+    private:
+        lock_free_stack* owner_ = nullptr;
+        std::uint32_t head_ = kNull;
+
+        friend class lock_free_stack;
+        batch(lock_free_stack* owner, std::uint32_t head) : owner_(owner), head_(head) {}
+
+    public:
+        batch() = default;
+        batch(batch&& other) noexcept
+            : owner_(other.owner_), head_(std::exchange(other.head_, kNull)) {}
+        batch& operator=(batch&& other) noexcept
+        {
+            if (this != &other)
+            {
+                clear();
+                owner_ = other.owner_;
+                head_ = std::exchange(other.head_, kNull);
+            }
+            return *this;
+        }
+        ~batch() { clear(); }
+
+        bool empty() const noexcept { return head_ == kNull; }
+        T& top() const { return *owner_->node(head_).value(); }
+
+        void pop()
+        {
+            Node& n = owner_->node(head_);
+            const std::uint32_t next = n.next.load(std::memory_order_relaxed);
+            n.value()->~T();
+            owner_->release_node(head_);
+            head_ = next;
+        }
+
+        void clear()
+        {
+            while (!empty())
+            {
+                pop();
+            }
+        }
+    };
+
+    // elimination_slots：消除槽位数，0表示按硬件线程数的一半选取
+    explicit lock_free_stack(std::size_t elimination_slots = 0)
+        : elimination_size_(elimination_slots ? elimination_slots : default_elimination_slots())
+    {
+        elimination_.reset(new EliminationSlot[elimination_size_]);
+    }
+
+    lock_free_stack(const lock_free_stack&) = delete;
+    lock_free_stack& operator=(const lock_free_stack&) = delete;
+
+    ~lock_free_stack()
+    {
+        // 析构时没有并发访问：销毁栈中剩余元素并释放节点池
+        for (std::uint32_t i = index_of(head_.load(std::memory_order_relaxed)); i != kNull;)
+        {
+            Node& n = node(i);
+            n.value()->~T();
+            i = n.next.load(std::memory_order_relaxed);
+        }
+        for (std::size_t s = 0; s < kMaxSegments; ++s)
+        {
+            delete[] segments_[s].load(std::memory_order_relaxed);
+        }
+    }
+
+    void push(T value)
+    {
+        push_node(make_node(std::move(value)));
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        push_node(make_node(std::forward<Args>(args)...));
+    }
+
+    bool try_pop(T& value)
+    {
+        const std::uint32_t index = pop_node();
+        if (index == kNull)
+        {
+            return false;
+        }
+        value = take(index);
+        return true;
+    }
+
+    std::optional<T> try_pop()
+    {
+        const std::uint32_t index = pop_node();
+        if (index == kNull)
+        {
+            return std::nullopt;
+        }
+        return take(index);
+    }
+
+    // 与thread_safe_stack一致：栈为空时抛出stack_empty
+    void pop(T& value)
+    {
+        if (!try_pop(value))
+        {
+            throw stack_empty();
+        }
+    }
+
+    std::shared_ptr<T> pop()
+    {
+        const std::uint32_t index = pop_node();
+        if (index == kNull)
+        {
+            throw stack_empty();
+        }
+        return std::make_shared<T>(take(index));
+    }
+
+    // 批量入栈：先在私有链上构造全部节点，再用一次CAS把整条链接到栈顶；
+    // 入栈顺序与逐个push相同，即区间最后一个元素位于栈顶
+    template <typename InputIt>
+    void push_range(InputIt first, InputIt last)
+    {
+        std::uint32_t top = kNull;
+        std::uint32_t bottom = kNull;
+        try
+        {
+            for (; first != last; ++first)
+            {
+                const std::uint32_t index = make_node(*first);
+                node(index).next.store(top, std::memory_order_relaxed);
+                if (bottom == kNull)
+                {
+                    bottom = index;
+                }
+                top = index;
+            }
+        }
+        catch (...)
+        {
+            batch(this, top);  // 构造失败时销毁已构造的部分
+            throw;
+        }
+        if (top == kNull)
+        {
+            return;
+        }
+
+        Node& tail = node(bottom);
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        do
+        {
+            tail.next.store(index_of(head), std::memory_order_relaxed);
+        } while (!head_.compare_exchange_weak(head, pack(top, tag_of(head) + 1),
+            std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // 一次CAS取下整个栈，O(1)
+    batch pop_all()
+    {
+        std::uint64_t head = head_.load(std::memory_order_acquire);
+        while (index_of(head) != kNull && !head_.compare_exchange_weak(head, pack(kNull, tag_of(head) + 1),
+            std::memory_order_acquire, std::memory_order_acquire))
+        {
+        }
+        return batch(this, index_of(head));
+    }
+
+    bool empty() const
+    {
+        return index_of(head_.load(std::memory_order_acquire)) == kNull;
+    }
+
+private:
+    static std::size_t default_elimination_slots()
+    {
+        const std::size_t threads = std::thread::hardware_concurrency();
+        return std::max<std::size_t>(1, std::min<std::size_t>(64, threads / 2));
+    }
+
+    // 下标 -> 节点：第k段覆盖下标[64*(2^k-1), 64*(2^(k+1)-1))
+    Node& node(std::uint32_t index) const noexcept
+    {
+        const std::size_t q = index / kFirstSegment + 1;
+        const std::size_t segment = std::bit_width(q) - 1;
+        const std::size_t offset = index - kFirstSegment * ((std::size_t(1) << segment) - 1);
+        return segments_[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    template <typename... Args>
+    std::uint32_t make_node(Args&&... args)
+    {
+        const std::uint32_t index = allocate_node();
+        Node& n = node(index);
+        try
+        {
+            ::new (static_cast<void*>(n.storage)) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            release_node(index);
+            throw;
+        }
+        return index;
+    }
+
+    // 取出节点中的元素并回收节点（调用者已独占该节点）
+    T take(std::uint32_t index)
+    {
+        Node& n = node(index);
+        T value = std::move(*n.value());
+        n.value()->~T();
+        release_node(index);
+        return value;
+    }
+
+    // 从空闲链表取节点，空闲链表为空时从节点池分配新节点
+    std::uint32_t allocate_node()
+    {
+        const std::uint32_t index = pop_list(free_);
+        if (index != kNull)
+        {
+            return index;
+        }
+
+        const std::uint32_t fresh = next_fresh_.fetch_add(1, std::memory_order_relaxed);
+        const std::size_t q = fresh / kFirstSegment + 1;
+        const std::size_t segment = std::bit_width(q) - 1;
+        if (segment >= kMaxSegments)
+        {
+            throw std::bad_alloc();
+        }
+        if (segments_[segment].load(std::memory_order_acquire) == nullptr)
+        {
+            // 多个线程可能同时分配同一段，只保留第一个成功发布的
+            Node* fresh_segment = new Node[kFirstSegment << segment];
+            Node* expected = nullptr;
+            if (!segments_[segment].compare_exchange_strong(expected, fresh_segment,
+                std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                delete[] fresh_segment;
+            }
+        }
+        return fresh;
+    }
+
+    void release_node(std::uint32_t index)
+    {
+        push_list(free_, index);
+    }
+
+    // 带版本号的链表操作，栈顶与空闲链表共用
+    void push_list(std::atomic<std::uint64_t>& list, std::uint32_t index)
+    {
+        Node& n = node(index);
+        std::uint64_t head = list.load(std::memory_order_relaxed);
+        while (true)
+        {
+            n.next.store(index_of(head), std::memory_order_relaxed);
+            if (list.compare_exchange_weak(head, pack(index, tag_of(head) + 1),
+                std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+
+    std::uint32_t pop_list(std::atomic<std::uint64_t>& list)
+    {
+        std::uint64_t head = list.load(std::memory_order_acquire);
+        while (index_of(head) != kNull)
+        {
+            // 节点不会被释放，即使它已被其他线程弹出，读取next也是安全的；此时版本号已变，下面的CAS会失败
+            const std::uint32_t next = node(index_of(head)).next.load(std::memory_order_relaxed);
+            if (list.compare_exchange_weak(head, pack(next, tag_of(head) + 1),
+                std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return index_of(head);
+            }
+        }
+        return kNull;
+    }
+
+    void push_node(std::uint32_t index)
+    {
+        Node& n = node(index);
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            n.next.store(index_of(head), std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(head, pack(index, tag_of(head) + 1),
+                std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+            // 栈顶有竞争：尝试与并发的pop配对消除
+            if (offer_for_elimination(index))
+            {
+                return;
+            }
+            head = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::uint32_t pop_node()
+    {
+        std::uint64_t head = head_.load(std::memory_order_acquire);
+        while (index_of(head) != kNull)
+        {
+            const std::uint32_t next = node(index_of(head)).next.load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(head, pack(next, tag_of(head) + 1),
+                std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return index_of(head);
+            }
+            // 栈顶有竞争：尝试接收并发push放在消除槽位中的节点
+            const std::uint32_t eliminated = take_from_elimination();
+            if (eliminated != kNull)
+            {
+                return eliminated;
+            }
+            head = head_.load(std::memory_order_acquire);
+        }
+        return kNull;
+    }
+
+    // push方：把节点放入随机槽位等待一段时间，被pop取走返回true；超时则撤回
+    bool offer_for_elimination(std::uint32_t index)
+    {
+        EliminationSlot& slot = elimination_[random_slot()];
+        std::uint32_t expected = kNull;
+        if (!slot.node.compare_exchange_strong(expected, index,
+            std::memory_order_release, std::memory_order_relaxed))
+        {
+            return false;  // 槽位已被占用
+        }
+
+        for (int spin = 0; spin < kEliminationSpins; ++spin)
+        {
+            if (slot.node.load(std::memory_order_relaxed) != index)
+            {
+                return true;  // 已被pop取走
+            }
+        }
+
+        // 撤回失败说明恰好在撤回前被取走
+        expected = index;
+        return !slot.node.compare_exchange_strong(expected, kNull,
+            std::memory_order_relaxed, std::memory_order_relaxed);
+    }
+
+    // pop方：查看随机槽位，有等待配对的push节点时取走
+    std::uint32_t take_from_elimination()
+    {
+        EliminationSlot& slot = elimination_[random_slot()];
+        std::uint32_t index = slot.node.load(std::memory_order_relaxed);
+        if (index != kNull && slot.node.compare_exchange_strong(index, kNull,
+            std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            return index;
+        }
+        return kNull;
+    }
+
+    std::size_t random_slot() const
+    {
+        thread_local std::minstd_rand gen(static_cast<unsigned>(
+            std::hash<std::thread::id>{}(std::this_thread::get_id())));
+        return gen() % elimination_size_;
+    }
+};
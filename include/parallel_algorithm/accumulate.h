@@ -4,9 +4,11 @@
 #include <iterator>
 #include <type_traits> // 用于std::enable_if、std::void_t
 #include <algorithm>
-#include <thread>
 #include <numeric>
 #include <string>
+#include <vector>
+#include "thread_pool.h"
+#include "execution_policy.h"
 
 // 1. 单位元获取模板（默认需要用户显式提供，或为标准操作特化）
 template <typename BinaryOp, typename T>
@@ -99,124 +101,119 @@ T my_accumulate(InputIt first, InputIt last, T init, BinaryOp op)
 }
 
 
-//AI给的并行版本实现
+//AI给的并行版本实现，分块任务在线程池上执行（调用线程同时处理第一块，numa_local时全部交给工作线程）
+// 任务数、粒度与执行器由执行策略决定；parallel_unsequenced时块内使用std::reduce（允许重排求值顺序以便编译器向量化），要求op可交换、可结合
 template<typename InputIt, typename T, typename BinaryOp>
-T parallel_accumulate(InputIt first, InputIt last, T init, BinaryOp op)
+T parallel_accumulate(const execution_policy& policy, InputIt first, InputIt last, T init, BinaryOp op)
 {
     // 计算范围大小
-    auto length = std::distance(first, last);
+    const size_t length = std::distance(first, last);
     if (length == 0) return init; // 如果范围为空，直接返回初始值
-    // 使用线程数来划分任务
-    const size_t min_per_thread = 25; // 每个线程至少处理的元素数
-    const size_t max_threads = (length + min_per_thread - 1) / min_per_thread; // 计算最大线程数
-    const size_t num_threads = std::min(max_threads, static_cast<size_t>(std::thread::hardware_concurrency())); // 获取硬件支持的线程数
-    if (num_threads == 0)  return init; // 直接返回初始值，如果没有可用线程
-    auto block_size = length / num_threads;
+    if (policy.is_sequential() && policy.cancellation == nullptr) return std::accumulate(first, last, std::move(init), op);
 
+    // 按执行策略划分任务，默认每个任务至少处理25个元素
+    const size_t num_threads = policy.task_count(length, 25);
+    const size_t block_size = length / num_threads;
 
     std::vector<T> results(num_threads);
-    // 启动多个线程进行并行计算
-    std::vector<std::thread> threads;
     // 获取当前操作的单位元（局部初始值）
     const T local_init = identity_element<BinaryOp, T>::get();
-    for (unsigned i = 0; i < num_threads; ++i)
+    const bool vectorized = policy.is_vectorized();
+    auto accumulate_range = [&op, &local_init, vectorized](InputIt block_start, InputIt block_end)
     {
-        auto block_start = first + i * block_size;
-        auto block_end = (i == num_threads - 1) ? last : block_start + block_size;
-        threads.emplace_back([block_start, block_end, &results, i, op, local_init]()
+        //使用单位元模板优化
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<InputIt>::iterator_category>)
+        {
+            if (vectorized)
             {
-                /*
-                * 使用条件分支是因为T()作为初始值时，可能会导致结果不正确,例如如果T是int类型，初始值为0，乘法操作会导致结果为0
-auto distance = std::distance(block_start, block_end);
-                if (distance == 1) results[i] = *block_start; // 只有一个元素，直接赋值
-                else if (distance == 2)
-                {
-                    results[i] = op(*block_start, *(block_start + 1)); // 两个元素，直接计算
-                }
-                else
-                {
-                    results[i] = std::accumulate(block_start + 1, block_end, *block_start, op); // 多元素：用第一个元素作为初始值，累加剩余元素
-                }
-
-                */
-
-                //使用单位元模板优化
-                results[i] = std::accumulate(block_start, block_end, local_init, op);
-            });
-    }
-    // 等待所有线程完成
-    for (auto& t : threads)
+                return std::reduce(block_start, block_end, local_init, op);
+            }
+        }
+        return std::accumulate(block_start, block_end, local_init, op);
+    };
+    // 可取消时块内每65536个元素检查一次停止请求
+    auto accumulate_block = [&](InputIt block_start, InputIt block_end)
     {
-        t.join();
+        if (policy.cancellation == nullptr)
+        {
+            return accumulate_range(block_start, block_end);
+        }
+        const size_t check_interval = size_t(1) << 16;
+        T result = local_init;
+        for (size_t remaining = std::distance(block_start, block_end); remaining > 0;)
+        {
+            policy.throw_if_stopped();
+            const size_t step = std::min(remaining, check_interval);
+            InputIt step_end = std::next(block_start, step);
+            result = op(std::move(result), accumulate_range(block_start, step_end));
+            block_start = step_end;
+            remaining -= step;
+        }
+        return result;
+    };
+
+    if (policy.is_sequential())
+    {
+        return op(std::move(init), accumulate_block(first, last));
     }
+
+    // 第0块默认由调用线程处理；numa_local时每块固定交给同一工作线程
+    run_blocks(policy, num_threads, [&](size_t i)
+        {
+            auto block_start = std::next(first, i * block_size);
+            auto block_end = (i == num_threads - 1) ? last : std::next(block_start, block_size);
+            results[i] = accumulate_block(block_start, block_end);
+        });
     // 合并结果
-    if (results.size() == 1) return results[0]; // 如果只有一个线程，直接返回结果
     return my_accumulate(results.begin(), results.end(), init, op);
 }
 
 template<typename InputIt, typename T>
-T parallel_accumulate(InputIt first, InputIt last, T init)
+T parallel_accumulate(const execution_policy& policy, InputIt first, InputIt last, T init)
 {
     auto op = [](T a, T b) { return a + b; }; // 默认加法操作
-    // 如果没有提供二元操作，则使用默认加法
-    return parallel_accumulate(first, last, init, op);
+    return parallel_accumulate(policy, first, last, init, op);
 }
 
+template<typename InputIt, typename T, typename BinaryOp>
+T parallel_accumulate(ThreadPool& pool, InputIt first, InputIt last, T init, BinaryOp op)
+{
+    return parallel_accumulate(execution::par.on(pool), first, last, init, op);
+}
 
-// 并行accumulate实现
-template <typename RandomIt, typename T, typename BinaryOp>
-T parallel_accumulate(RandomIt first, RandomIt last, T init, BinaryOp op,
-    size_t num_threads)
+template<typename InputIt, typename T, typename BinaryOp>
+T parallel_accumulate(InputIt first, InputIt last, T init, BinaryOp op)
 {
-    // 1. 处理空范围或单线程场景（直接调用串行版本）
-    const size_t total_elements = std::distance(first, last);
-    if (total_elements == 0) return init;
-    if (num_threads == 0) num_threads = 1; // 避免线程数为0
-    num_threads = std::min(num_threads, total_elements); // 线程数不超过元素数
-    const size_t effective_threads = std::min(num_threads, static_cast<size_t>(std::thread::hardware_concurrency()));
-
-    // 2. 划分每个线程处理的子范围
-    const size_t block_size = total_elements / effective_threads;
-    std::vector<T> local_results(effective_threads); // 存储每个线程的局部结果
-    std::vector<std::thread> threads;
-    threads.reserve(effective_threads);
-
-    // 3. 启动线程处理子范围
-    RandomIt current = first;
-    for (size_t i = 0; i < effective_threads; ++i)
-    {
-        RandomIt block_last = current;
-        if (i == effective_threads - 1)
-        {
-            block_last = last; // 最后一个线程处理剩余所有元素
-        }
-        else
-        {
-            std::advance(block_last, block_size);
-        }
+    return parallel_accumulate(execution::par, first, last, init, op);
+}
 
-        // 每个线程计算局部累加结果
-        threads.emplace_back(
-            [=, &local_results, &op](size_t thread_idx) {
-                // 对当前子块调用串行accumulate，初始值为T()（需确保T可默认构造）
-                local_results[thread_idx] = std::accumulate(current, block_last, T(), op);
-            },
-            i // 传递线程索引
-        );
+template<typename InputIt, typename T>
+T parallel_accumulate(ThreadPool& pool, InputIt first, InputIt last, T init)
+{
+    return parallel_accumulate(execution::par.on(pool), first, last, init);
+}
 
-        current = block_last;
-    }
+template<typename InputIt, typename T>
+T parallel_accumulate(InputIt first, InputIt last, T init)
+{
+    // 如果没有提供二元操作，则使用默认加法
+    return parallel_accumulate(execution::par, first, last, init);
+}
 
-    // 4. 等待所有线程完成
-    for (auto& t : threads)
-    {
-        if (t.joinable())
-        {
-            t.join();
-        }
-    }
 
-    // 5. 合并所有局部结果（用初始值init开始，对local_results累加）
-    return std::accumulate(local_results.begin(), local_results.end(), init, op);
+// 并行accumulate实现，num_threads限制最多同时执行的任务数（不限制粒度，等价于threads(num_threads).grain(1)的执行策略）
+template <typename RandomIt, typename T, typename BinaryOp>
+T parallel_accumulate(ThreadPool& pool, RandomIt first, RandomIt last, T init, BinaryOp op,
+    size_t num_threads)
+{
+    if (num_threads == 0) num_threads = 1; // 避免线程数为0
+    return parallel_accumulate(execution::par.on(pool).threads(num_threads).grain(1), first, last, init, op);
 }
 
+template <typename RandomIt, typename T, typename BinaryOp>
+T parallel_accumulate(RandomIt first, RandomIt last, T init, BinaryOp op,
+    size_t num_threads)
+{
+    return parallel_accumulate(default_thread_pool(), first, last, init, op, num_threads);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+#include <coro/task.h>
+#include "execution_policy.h"
+#include "accumulate.h"
+#include "merge_sort.h"
+
+/*
+并行算法的异步版本：调用后立即返回async_result，算法在执行策略的线程池上运行（计算与调用者的I/O重叠），
+普通代码用get()等待，协程中co_await等待。
+- 可选的std::stop_token用于协作式取消（例如请求超时后放弃长时间的排序）：停止请求生效后算法在下一个块/子任务边界
+  停止，get()或co_await抛出operation_cancelled。执行策略中的cancellation指针不会被使用（异步执行时它指向的token
+  可能已失效），以stop参数为准。
+- async_parallel_merge_sort按值接收数组并在结果中返回排好序的数组，调用者不必保证数组在执行期间有效；
+  async_parallel_accumulate只保存迭代器，范围在完成前必须有效。
+- 线程池没有工作线程时算法在调用线程执行完毕后才返回。
+*/
+template<typename InputIt, typename T, typename BinaryOp>
+    requires (!std::is_same_v<std::decay_t<BinaryOp>, std::stop_token>)
+async_result<T> async_parallel_accumulate(const execution_policy& policy, InputIt first, InputIt last, T init,
+    BinaryOp op, std::stop_token stop = {})
+{
+    return run_async(policy.pool(), [policy, first, last, init = std::move(init), op, stop = std::move(stop)]() mutable {
+        return parallel_accumulate(policy.cancel_on(stop), first, last, std::move(init), op);
+        });
+}
+
+template<typename InputIt, typename T>
+async_result<T> async_parallel_accumulate(const execution_policy& policy, InputIt first, InputIt last, T init,
+    std::stop_token stop = {})
+{
+    return run_async(policy.pool(), [policy, first, last, init = std::move(init), stop = std::move(stop)]() mutable {
+        return parallel_accumulate(policy.cancel_on(stop), first, last, std::move(init));
+        });
+}
+
+template <typename T, typename Compare = SafeComparator<T>>
+async_result<std::vector<T>> async_parallel_merge_sort(const execution_policy& policy, std::vector<T> arr,
+    std::stop_token stop = {})
+{
+    return run_async(policy.pool(), [policy, arr = std::move(arr), stop = std::move(stop)]() mutable {
+        parallel_merge_sort<T, Compare>(policy.cancel_on(stop), arr);
+        return std::move(arr);
+        });
+}
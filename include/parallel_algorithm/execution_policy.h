@@ -0,0 +1,192 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <stop_token>
+#include "thread_pool.h"
+
+// 执行策略的停止请求生效时由并行算法抛出
+class operation_cancelled : public std::runtime_error
+{
+public:
+    operation_cancelled() : std::runtime_error("parallel algorithm cancelled") {}
+};
+
+/*
+并行算法统一的执行策略参数：执行方式 + 任务数上限 + 任务粒度 + 执行器，
+各调用点可按自己的核心预算单独调整，不必修改算法头文件。
+- sequential：在调用线程中串行执行；parallel：分块在线程池上执行；
+  parallel_unsequenced：在parallel基础上允许块内向量化（调用者保证操作可交换、可结合且无数据依赖）。
+- max_threads：一次调用最多同时执行的任务数，0表示使用执行器的并发度（工作线程数+1），且不会超过该并发度。
+- grain_size：每个任务至少处理的元素数，0表示使用各算法自己的默认粒度。
+- executor：执行任务的线程池，nullptr表示default_thread_pool()。
+- numa_local：静态分块的算法（accumulate、for_each_s、prefix）把第i块固定交给第i % size()个工作线程，调用线程只等待；
+  线程池按affinity_policy绑核时，先用同一策略并行初始化数据（首次访问决定内存页所在的节点）、再并行计算，
+  每块数据都在本节点上访问。动态分块的for_each_d与递归的merge_sort不受影响。
+- cancellation：协作式取消，收到停止请求后算法在下一个块/子任务边界抛出operation_cancelled（已开始的块照常完成）；
+  只保存指针，调用期间token必须有效（异步版本会把token复制到自己的状态中）。
+用法：parallel_accumulate(execution::par.threads(4).grain(1000).on(pool), first, last, 0)。
+*/
+enum class execution_mode
+{
+    sequential,
+    parallel,
+    parallel_unsequenced
+};
+
+struct execution_policy
+{
+    execution_mode mode = execution_mode::parallel;
+    std::size_t max_threads = 0;
+    std::size_t grain_size = 0;
+    ThreadPool* executor = nullptr;
+    bool numa_local = false;
+    const std::stop_token* cancellation = nullptr;
+
+    // 以下构造器返回修改后的副本，便于在调用点链式书写
+    constexpr execution_policy threads(std::size_t n) const
+    {
+        execution_policy copy = *this;
+        copy.max_threads = n;
+        return copy;
+    }
+
+    constexpr execution_policy grain(std::size_t n) const
+    {
+        execution_policy copy = *this;
+        copy.grain_size = n;
+        return copy;
+    }
+
+    constexpr execution_policy on(ThreadPool& pool) const
+    {
+        execution_policy copy = *this;
+        copy.executor = &pool;
+        return copy;
+    }
+
+    constexpr execution_policy numa() const
+    {
+        execution_policy copy = *this;
+        copy.numa_local = true;
+        return copy;
+    }
+
+    constexpr execution_policy cancel_on(const std::stop_token& token) const
+    {
+        execution_policy copy = *this;
+        copy.cancellation = &token;
+        return copy;
+    }
+
+    constexpr bool is_sequential() const noexcept { return mode == execution_mode::sequential; }
+    constexpr bool is_vectorized() const noexcept { return mode == execution_mode::parallel_unsequenced; }
+
+    ThreadPool& pool() const
+    {
+        return executor != nullptr ? *executor : default_thread_pool();
+    }
+
+    constexpr std::size_t grain_or(std::size_t default_grain) const noexcept
+    {
+        return grain_size != 0 ? grain_size : default_grain;
+    }
+
+    bool stop_requested() const noexcept
+    {
+        return cancellation != nullptr && cancellation->stop_requested();
+    }
+
+    void throw_if_stopped() const
+    {
+        if (stop_requested())
+        {
+            throw operation_cancelled();
+        }
+    }
+
+    // 一次调用最多同时执行的任务数
+    std::size_t thread_limit() const
+    {
+        if (is_sequential())
+        {
+            return 1;
+        }
+        // numa_local时调用线程不处理数据块，只计工作线程
+        const std::size_t concurrency = pinned() ? pool().size() : pool().concurrency();
+        return max_threads != 0 ? std::min(max_threads, concurrency) : concurrency;
+    }
+
+    // 是否按numa_local把数据块固定分配给工作线程（线程池没有工作线程时退化为在调用线程执行）
+    bool pinned() const
+    {
+        return numa_local && !is_sequential() && pool().size() > 0;
+    }
+
+    // 处理length个元素的任务数：不超过按粒度划分的块数与任务数上限，至少为1
+    std::size_t task_count(std::size_t length, std::size_t default_grain) const
+    {
+        const std::size_t grain = grain_or(default_grain);
+        const std::size_t blocks = (length + grain - 1) / grain;
+        return std::max<std::size_t>(1, std::min(blocks, thread_limit()));
+    }
+};
+
+// 预定义策略，与std::execution::seq/par/par_unseq对应
+namespace execution
+{
+    inline constexpr execution_policy seq{ execution_mode::sequential };
+    inline constexpr execution_policy par{ execution_mode::parallel };
+    inline constexpr execution_policy par_unseq{ execution_mode::parallel_unsequenced };
+}
+
+// 按执行策略并行执行block(0)…block(count-1)，全部完成后返回，重新抛出第一个异常。
+// 默认第0块在调用线程执行、其余块交给线程池；numa_local时第i块固定由第i % size()个工作线程执行，
+// 因此同一长度、同一策略的多次调用中，每块总在同一工作线程上处理；收到停止请求后尚未开始的块不再执行
+template <typename BlockFn>
+void run_blocks(const execution_policy& policy, std::size_t count, BlockFn&& block)
+{
+    const bool pinned = policy.pinned();
+    auto checked = [&policy, &block](std::size_t i) {
+        policy.throw_if_stopped();
+        block(i);
+        };
+    TaskGroup group(policy.pool());
+    for (std::size_t i = pinned ? 0 : 1; i < count; ++i)
+    {
+        if (pinned)
+        {
+            group.run_on(i, [&checked, i] { checked(i); });
+        }
+        else
+        {
+            group.run([&checked, i] { checked(i); });
+        }
+    }
+
+    std::exception_ptr error;
+    if (!pinned && count > 0)
+    {
+        try
+        {
+            checked(0);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    }
+    try
+    {
+        group.wait();
+    }
+    catch (...)
+    {
+        if (!error) error = std::current_exception();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
@@ -2,9 +2,13 @@
 #include<iterator>
 #include<vector>
 #include<exception>
-#include<mutex>
 #include<algorithm>
-#include<queue>
+#include<atomic>
+#include<string>
+#include<stdexcept>
+#include<utility>
+#include "thread_pool.h"
+#include "execution_policy.h"
 
 //串行遍历算法实现
 template<typename First, typename Last, typename Func>
@@ -17,188 +21,193 @@ Func my_for_each(First first, Last last, Func func)
     return func;
 }
 
-//并发遍历算法实现，静态分割
+// 重新抛出并行遍历中捕获的第一个异常，std::exception包装为带前缀的runtime_error；
+// operation_cancelled原样抛出，调用者可以按类型区分取消与失败
+inline void rethrow_for_each_error(std::exception_ptr eptr)
+{
+    try
+    {
+        std::rethrow_exception(eptr); // 重新抛出捕获的异常
+    }
+    catch (const operation_cancelled&)
+    {
+        throw;
+    }
+    catch (const std::exception& e)
+    {
+        throw std::runtime_error(std::string("Parallel for_each failed: ") + e.what());
+    }
+}
+
+//并发遍历算法实现，静态分割，每块作为一个任务在线程池上执行
+// 块内直接使用std::for_each（不依赖并行STL的后端），parallel_unsequenced与parallel相同
 template<typename InputIt, typename Func>
-void parallel_for_each_s(InputIt first, InputIt last, Func func)
+void parallel_for_each_s(const execution_policy& policy, InputIt first, InputIt last, Func func)
 {
     size_t distance = std::distance(first, last);
     if (distance == 0) return;
+    if (policy.is_sequential())
+    {
+        policy.throw_if_stopped();
+        // 异常与并行执行时一致地包装
+        try
+        {
+            std::for_each(first, last, func);
+        }
+        catch (...)
+        {
+            rethrow_for_each_error(std::current_exception());
+        }
+        return;
+    }
 
-    // 1. 确定线程数和最小任务粒度
-    const size_t min_per_thread = 25; // 每个线程至少处理25个元素
-    const size_t hardware_threads = std::thread::hardware_concurrency();
-    const size_t max_threads = (distance + min_per_thread - 1) / min_per_thread;
-
-    // 确保线程数不超过硬件支持的线程数
-    const size_t num_threads = std::min(hardware_threads != 0 ? hardware_threads : 2, max_threads);
+    // 1. 按执行策略确定任务数，默认每个任务至少处理25个元素，且不超过线程池的并发度
+    const size_t num_threads = policy.task_count(distance, 25);
 
-    // 2. 计算每个线程处理的范围
+    // 2. 计算每个任务处理的范围（最后一块包含余下的元素）
     const size_t block_size = distance / num_threads;
-    std::vector<std::thread> threads(num_threads); // 创建线程容器。
-
-    //异常处理
-    std::exception_ptr eptr; // 用于存储异常指针
-    std::mutex mtx; // 互斥锁，用于保护异常指针
-
-    // 3. 启动线程并分配任务
+    std::vector<InputIt> bounds;
+    bounds.reserve(num_threads + 1);
     InputIt block_start = first;
-    for (int i = 0; i < num_threads - 1; ++i)
+    for (size_t i = 0; i < num_threads; ++i)
     {
-        InputIt block_end = block_start;
-        std::advance(block_end, block_size);
-        threads[i] = std::thread([block_start, block_end, &func, &eptr, &mtx]() {
-            try
-            {
-                std::for_each(block_start, block_end, func);
-            }
-            catch (...)
-            {
-                std::lock_guard<std::mutex> lock(mtx);
-                eptr = std::current_exception(); // 捕获异常
-            }
-            });
-        block_start = block_end;
+        bounds.push_back(block_start);
+        if (i + 1 < num_threads) std::advance(block_start, block_size);
     }
+    bounds.push_back(last);
 
-    // 处理最后一个块
-    InputIt block_end = last;
+    // 3. 执行并等待所有块完成：第0块默认由当前线程处理，numa_local时每块固定交给同一工作线程
     try
     {
-        std::for_each(block_start, block_end, func);
+        run_blocks(policy, num_threads, [&](size_t i) {
+            std::for_each(bounds[i], bounds[i + 1], func);
+            });
     }
     catch (...)
     {
-        std::lock_guard<std::mutex> lock(mtx);
-        eptr = std::current_exception(); // 捕获异常
+        //4. 处理异常
+        rethrow_for_each_error(std::current_exception());
     }
+}
 
-    // 4. 等待所有线程完成
-    for (auto& thread : threads)
-    {
-        if (thread.joinable())
-        {
-            thread.join();
-        }
-    }
+template<typename InputIt, typename Func>
+void parallel_for_each_s(ThreadPool& pool, InputIt first, InputIt last, Func func)
+{
+    parallel_for_each_s(execution::par.on(pool), first, last, func);
+}
 
-    //5. 处理异常
-    if (eptr)
-    {
-        try
-        {
-            std::rethrow_exception(eptr); // 重新抛出捕获的异常
-        }
-        catch (const std::exception& e)
-        {
-            throw std::runtime_error(std::string("Parallel for_each failed: ") + e.what());
-        }
-    }
+template<typename InputIt, typename Func>
+void parallel_for_each_s(InputIt first, InputIt last, Func func)
+{
+    parallel_for_each_s(execution::par, first, last, func);
 }
 
 template<typename InputIt, typename Func>
-void parallel_for_each_d(InputIt first, InputIt last, Func func)
+void parallel_for_each_d(const execution_policy& policy, InputIt first, InputIt last, Func func)
 {
     // 并发遍历算法实现，动态分割
     // 计算总元素数量
     const size_t distance = std::distance(first, last);
     if (distance == 0) return;
+    if (policy.is_sequential())
+    {
+        policy.throw_if_stopped();
+        // 异常与并行执行时一致地包装
+        try
+        {
+            std::for_each(first, last, func);
+        }
+        catch (...)
+        {
+            rethrow_for_each_error(std::current_exception());
+        }
+        return;
+    }
 
-    // 1. 确定线程数和最小任务粒度
-    const size_t min_per_thread = 25; // 每个线程至少处理25个元素
+    // 1. 确定最小任务粒度
+    const size_t min_per_thread = policy.grain_or(25); // 每块默认至少25个元素
     const size_t num_blocks = std::max<size_t>(1, (distance + min_per_thread - 1) / min_per_thread);
     const size_t block_size = std::max<size_t>(1, distance / num_blocks); 
 
-    // 2. 线程安全的任务队列：存储待处理的[start, end)范围
-    std::queue<std::pair<InputIt, InputIt>> task_queue; // 任务队列
-    std::mutex queue_mutex; // 互斥锁，用于保护任务队列
-    std::condition_variable cv; // 条件变量，用于线程同步
-    std::atomic<bool> done{ false }; // 标志，表示任务是否完成
-    std::exception_ptr eptr; // 用于存储异常指针
-
-    // 3. 将任务分割成块并添加到队列
+    // 2. 将范围分割成块：存储待处理的[start, end)
+    std::vector<std::pair<InputIt, InputIt>> blocks;
+    blocks.reserve(num_blocks);
     InputIt block_start = first;
     InputIt block_end = first;
-    for(int i = 0; i < num_blocks -1;i++)
+    for (size_t i = 0; i < num_blocks - 1; i++)
     {
         std::advance(block_end, block_size);
-        task_queue.push({ block_start, block_end });
+        blocks.push_back({ block_start, block_end });
         block_start = block_end;
     }
-    task_queue.push({ block_start, last }); // 添加最后一个块
+    blocks.push_back({ block_start, last }); // 添加最后一个块
 
-    // 4. 定制工作线程函数
+    // 3. 每个任务循环领取下一个块，先完成的任务自动多处理；领取前检查停止请求，出现异常或取消后停止领取
+    std::atomic<size_t> next_block{ 0 };
+    std::atomic<bool> failed{ false };
     auto worker = [&]() {
-        while (done)
+        while (!failed.load(std::memory_order_relaxed))
         {
-            std::pair<InputIt, InputIt> task;
+            try
             {
-                std::unique_lock<std::mutex> lock(queue_mutex);
-                cv.wait(lock, [&]() { return !task_queue.empty() || done.load(); });
-                if (done.load() && task_queue.empty())
+                policy.throw_if_stopped();
+                const size_t index = next_block.fetch_add(1, std::memory_order_relaxed);
+                if (index >= blocks.size())
                 {
-                    return; // 如果没有任务且已完成，退出线程
+                    return;
                 }
-                task = task_queue.front();
-                task_queue.pop();
-            }
-
-            try
-            {
-                std::for_each(task.first, task.second, func); // 执行任务
+                std::for_each(blocks[index].first, blocks[index].second, func); // 执行任务
             }
             catch (...)
             {
-                std::lock_guard<std::mutex> lock(queue_mutex);
-                if(!eptr) // 如果没有异常被捕获
-                {
-                    eptr = std::current_exception(); // 捕获异常
-                }
-
-                done.store(true,std::memory_order_release); // 设置完成标志
-                cv.notify_all(); // 通知所有线程
-                return; // 退出线程
+                failed.store(true, std::memory_order_relaxed);
+                throw;
             }
         }
         };
 
-    // 5. 启动工作线程
-    const size_t hardware_threads = std::thread::hardware_concurrency();
-    const size_t num_threads = std::min(hardware_threads != 0 ? hardware_threads : 2, task_queue.size()); // 确保线程数不超过硬件支持的线程数且线程数不超过任务数，避免空转。
-    std::vector<std::thread> threads;
-    threads.reserve(num_threads);
-    for(int i = 0; i < num_threads; ++i)
+    // 4. 任务数不超过执行策略的上限且不超过块数，避免空转；当前线程也作为一个任务参与
+    const size_t num_threads = std::min(policy.thread_limit(), blocks.size());
+    TaskGroup group(policy.pool());
+    for (size_t i = 1; i < num_threads; ++i)
     {
-        threads.emplace_back(worker); // 启动工作线程
+        group.run(worker);
     }
 
-    //6. 等待所有线程完成
+    std::exception_ptr eptr; // 用于存储异常指针
+    try
     {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        cv.wait(lock, [&]() { return done.load() || !task_queue.empty(); });
-        done.store(true, std::memory_order_release); // 设置完成标志,通知所有线程可以退出
+        worker();
+    }
+    catch (...)
+    {
+        eptr = std::current_exception();
     }
 
-    cv.notify_all(); // 通知所有线程
-
-    // 7. 等待所有线程结束
-    for(auto& thread : threads)
+    // 5. 等待所有任务结束
+    try
     {
-        if(thread.joinable())
-        {
-            thread.join(); // 等待线程结束
-        }
+        group.wait();
+    }
+    catch (...)
+    {
+        if (!eptr) eptr = std::current_exception();
     }
 
-    if(eptr) // 如果有异常被捕获
+    if (eptr) // 如果有异常被捕获
     {
-        try
-        {
-            std::rethrow_exception(eptr); // 重新抛出捕获的异常
-        }
-        catch (const std::exception& e)
-        {
-            throw std::runtime_error(std::string("Parallel for_each failed: ") + e.what());
-        }
+        rethrow_for_each_error(eptr);
     }
 }
 
+template<typename InputIt, typename Func>
+void parallel_for_each_d(ThreadPool& pool, InputIt first, InputIt last, Func func)
+{
+    parallel_for_each_d(execution::par.on(pool), first, last, func);
+}
+
+template<typename InputIt, typename Func>
+void parallel_for_each_d(InputIt first, InputIt last, Func func)
+{
+    parallel_for_each_d(execution::par, first, last, func);
+}
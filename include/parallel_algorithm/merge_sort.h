@@ -4,8 +4,9 @@
 #include <algorithm>
 #include <vector>
 #include <functional>
-#include <thread>
 #include <stdexcept>
+#include "thread_pool.h"
+#include "execution_policy.h"
 
 /*
 对于串行的merge_sort函数，要求自定义类型要实现<或者<=,==和默认的构造函数，否则无法实例化。
@@ -151,18 +152,20 @@ void merge_sort_serial(T* first, T* last, T* buffer, Compare comp)
     merge(first, mid, last, buffer, comp);
 }
 
-// 核心并行排序：带线程数控制
+// 核心并行排序：fork-join递归，左右两半并行排序后合并；只按粒度停止拆分，负载均衡由工作窃取线程池负责。
+// 每个子任务开始和合并前检查停止请求，取消后数组内容不确定
 template <typename T, typename Compare>
 void merge_sort_parallel_impl(
+    const execution_policy& policy,
     T* first, T* last, T* buffer, Compare comp,
-    size_t min_parallel_size,  // 最小并行粒度
-    size_t remaining_threads   // 剩余可用线程数
+    size_t min_parallel_size   // 最小并行粒度
 )
 {
     const size_t n = last - first;
+    policy.throw_if_stopped();
 
-    // 终止条件：子数组过小 或 无可用线程 → 切换串行
-    if (n <= min_parallel_size || remaining_threads == 0)
+    // 终止条件：子数组过小 → 切换串行
+    if (n <= min_parallel_size)
     {
         // 切换到串行归并排序
         //merge_sort_serial(first, last, buffer, comp);
@@ -172,63 +175,59 @@ void merge_sort_parallel_impl(
 
     T* mid = first + n / 2;
 
-    // 剩余线程数-1（分配1个线程给左半部分）
-    size_t new_remaining = remaining_threads - 1;
-
-    // 并行处理左半部分：创建线程，消耗1个可用名额
-    std::thread left_thread(
-        merge_sort_parallel_impl<T, Compare>,
-        first, mid, buffer, comp,
-        min_parallel_size,
-        new_remaining  // 左半部分可使用的线程数
-    );
-
-    // 当前线程处理右半部分：复用剩余线程名额
-    merge_sort_parallel_impl(
-        mid, last, buffer + (mid - first), comp,  // 修改buffer起始位置
-        min_parallel_size,
-        new_remaining  // 右半部分与左半部分共享剩余线程
-    );
-    // 等待左线程完成
-    left_thread.join();
+    // 右半部分作为子任务，当前线程处理左半部分，等待期间帮忙执行其他任务
+    parallel_invoke(policy.pool(),
+        [&] { merge_sort_parallel_impl(policy, first, mid, buffer, comp, min_parallel_size); },
+        [&] { merge_sort_parallel_impl(policy, mid, last, buffer + (mid - first), comp, min_parallel_size); });
 
     // 合并结果
+    policy.throw_if_stopped();
     merge(first, mid, last, buffer, comp);
 }
 
-// 对外接口：自动计算最大线程数
+// 对外接口：粒度、叶子子数组数上限与执行器由执行策略决定
+// 默认粒度10000；max_threads非0时加大粒度，使叶子子数组数约为max_threads（二分拆分，至多为不小于它的2的幂）；
+// sequential时整体串行排序；比较操作无法向量化，parallel_unsequenced与parallel相同
 template <typename T, typename Compare = SafeComparator<T>>
-void parallel_merge_sort(
-    std::vector<T>& arr,
-    size_t min_parallel_size = 10000,  // 最小并行粒度
-    size_t max_threads = 0            // 最大线程数（0表示自动获取）
-)
+void parallel_merge_sort(const execution_policy& policy, std::vector<T>& arr)
 {
     Compare comp;
     if (arr.empty()) return;
 
-    // 自动计算最大线程数：默认使用CPU核心数，至少为1
-    if (max_threads == 0)
-    {
-        max_threads = std::thread::hardware_concurrency() - 1;
-        if (max_threads == 0) max_threads = 1;  // 未知硬件时默认1线程
-    }
-    if (max_threads < 1)
+    size_t min_parallel_size = policy.is_sequential() ? arr.size() : policy.grain_or(10000);
+    if (policy.max_threads != 0)
     {
-        throw std::invalid_argument("max_threads must be at least 1");
-    }
-    else
-    {
-        max_threads = std::min(max_threads, static_cast<size_t>(std::thread::hardware_concurrency()));// 不超过数组大小
+        const size_t leaf_size = (arr.size() + policy.max_threads - 1) / policy.max_threads;
+        min_parallel_size = std::max(min_parallel_size, leaf_size);
     }
 
     std::vector<T> buffer(arr.size());  // 全局缓冲区
 
-    // 初始可用线程数为max_threads-1（预留当前线程）
     merge_sort_parallel_impl(
+        policy,
         arr.data(), arr.data() + arr.size(),
         buffer.data(), comp,
-        min_parallel_size,
-        max_threads - 1  // 减去当前线程，剩余用于创建新线程
+        min_parallel_size
     );
 }
+
+template <typename T, typename Compare = SafeComparator<T>>
+void parallel_merge_sort(
+    ThreadPool& pool,
+    std::vector<T>& arr,
+    size_t min_parallel_size = 10000,  // 最小并行粒度
+    size_t max_threads = 0            // 叶子子数组数上限的近似值（0表示不限制，由线程池调度）
+)
+{
+    parallel_merge_sort<T, Compare>(execution::par.on(pool).grain(min_parallel_size).threads(max_threads), arr);
+}
+
+template <typename T, typename Compare = SafeComparator<T>>
+void parallel_merge_sort(
+    std::vector<T>& arr,
+    size_t min_parallel_size = 10000,  // 最小并行粒度
+    size_t max_threads = 0            // 叶子子数组数上限的近似值（0表示不限制）
+)
+{
+    parallel_merge_sort<T, Compare>(execution::par.grain(min_parallel_size).threads(max_threads), arr);
+}
@@ -2,10 +2,12 @@
 #include <vector>
 #include <functional> // 用于std::function
 #include <stdexcept>
-#include <thread>
-#include <future>
 #include <atomic>
 #include <mutex>
+#include <algorithm>
+#include <numeric>
+#include "thread_pool.h"
+#include "execution_policy.h"
 
 // 通用前缀和计算函数
 // 参数：
@@ -61,17 +63,30 @@ namespace PrefixOps {
     }
 }
 
-//并发版本前缀和
+// Helper function: sequential prefix sum (for validation)
 template <typename T, typename Operation>
-std::vector<T> parallel_prefix(const std::vector<T>& arr, Operation op, const T& identity) {
+std::vector<T> sequential_prefix(const std::vector<T>& arr, Operation op, const T& identity) {
+    std::vector<T> result(arr.size() + 1);
+    result[0] = identity;
+    for (size_t i = 0; i < arr.size(); ++i) {
+        result[i + 1] = op(result[i], arr[i]);
+    }
+    return result;
+}
+
+//并发版本前缀和，分块任务在线程池上执行
+// 任务数、粒度与执行器由执行策略决定；parallel_unsequenced时块内使用std::inclusive_scan（允许重排求值顺序），要求op可结合
+template <typename T, typename Operation>
+std::vector<T> parallel_prefix(const execution_policy& policy, const std::vector<T>& arr, Operation op, const T& identity) {
     if (arr.empty()) return { identity };
+    if (policy.is_sequential()) {
+        policy.throw_if_stopped();
+        return sequential_prefix(arr, op, identity);
+    }
     
-    // 1. 确定线程数量和任务粒度
-    size_t num_threads = std::thread::hardware_concurrency();
-    if (num_threads == 0) num_threads = 2;
-    size_t min_per_thread = 32;
-    size_t max_threads = (arr.size() + min_per_thread - 1) / min_per_thread;
-    num_threads = std::min(num_threads, max_threads);
+    // 1. 按执行策略确定任务数量，默认每个任务至少处理32个元素
+    const size_t num_threads = policy.task_count(arr.size(), 32);
+    const bool vectorized = policy.is_vectorized();
 
     // 2. 使用连续内存布局
     struct Block {
@@ -96,16 +111,20 @@ std::vector<T> parallel_prefix(const std::vector<T>& arr, Operation op, const T&
     }
 
     // 3. 使用任务并行计算前缀和
-    std::vector<std::future<void>> futures;
     std::mutex mtx;
     
     auto process_block = [&](size_t block_idx) {
         auto& block = blocks[block_idx];
-        block.data[0] = arr[block.data - all_data.data()];
+        auto input = arr.begin() + (block.data - all_data.data());
         
         // 计算块内前缀和
-        for (size_t i = 1; i < block.size; ++i) {
-            block.data[i] = op(block.data[i-1], arr[block.data - all_data.data() + i]);
+        if (vectorized) {
+            std::inclusive_scan(input, input + block.size, block.data, op);
+        } else {
+            block.data[0] = input[0];
+            for (size_t i = 1; i < block.size; ++i) {
+                block.data[i] = op(block.data[i-1], input[i]);
+            }
         }
         
         // 使用原子操作更新偏移
@@ -115,13 +134,8 @@ std::vector<T> parallel_prefix(const std::vector<T>& arr, Operation op, const T&
         }
     };
 
-    // 启动任务
-    for (size_t i = 0; i < blocks.size(); ++i) {
-        futures.push_back(std::async(std::launch::async, process_block, i));
-    }
-
-    // 等待所有任务完成
-    for (auto& f : futures) f.wait();
+    // 执行并等待所有块完成：当前线程默认处理第一块，numa_local时每块固定交给同一工作线程
+    run_blocks(policy, blocks.size(), process_block);
 
     // 4. 计算全局偏移
     std::vector<T> global_offsets(blocks.size());
@@ -158,14 +172,14 @@ std::vector<T> parallel_prefix(const std::vector<T>& arr, Operation op, const T&
     return result;
 }
 
-// Helper function: sequential prefix sum (for validation)
 template <typename T, typename Operation>
-std::vector<T> sequential_prefix(const std::vector<T>& arr, Operation op, const T& identity) {
-    std::vector<T> result(arr.size() + 1);
-    result[0] = identity;
-    for (size_t i = 0; i < arr.size(); ++i) {
-        result[i + 1] = op(result[i], arr[i]);
-    }
-    return result;
+std::vector<T> parallel_prefix(ThreadPool& pool, const std::vector<T>& arr, Operation op, const T& identity) {
+    return parallel_prefix(execution::par.on(pool), arr, op, identity);
 }
 
+template <typename T, typename Operation>
+std::vector<T> parallel_prefix(const std::vector<T>& arr, Operation op, const T& identity) {
+    return parallel_prefix(execution::par, arr, op, identity);
+}
+
+
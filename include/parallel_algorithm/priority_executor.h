@@ -0,0 +1,204 @@
+#pragma once
+#include <thread>
+#include <vector>
+#include <functional>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <thread_safe_queue/hierarchical_priority_queue.h>
+
+/*
+按优先级调度的执行器：运行队列是HierarchicalPriorityQueue，紧急任务可以越过已排队的批量任务先执行。
+- 优先级为int，越大越先执行；同一有效优先级内按提交顺序执行。
+- 老化：每等待aging_interval相当于提升一级优先级，低优先级任务等得足够久后总能执行，不会被持续到来的
+  高优先级任务饿死。有效优先级 = priority + 等待时间 / aging_interval，两个任务的先后与当前时刻无关，
+  因此排序键在入队时即可确定（priority * aging_interval - 入队时刻），堆的顺序不会随时间失效。
+  priority * aging_interval饱和到±2^62纳秒（约146年），超出部分的优先级之间不再区分，排序键不会溢出，
+  也始终高于析构时使用的退出标记。
+- 工作线程内提交的任务进入该线程在HPQ中的局部队列，由它优先取回（数据在缓存中仍是热的），
+  达到合并阈值或滞留过久时才进入全局队列，空闲的工作线程会从中窃取；外部线程提交的任务直接进入全局队列，
+  全局队列内严格按有效优先级出队。
+- 析构时先执行完所有剩余任务，再回收工作线程。
+*/
+class PriorityExecutor
+{
+public:
+    using Task = std::function<void()>;
+
+    struct Options
+    {
+        std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        std::chrono::microseconds aging_interval{ 1000 };  // 每等待这么久提升一级优先级，0表示不老化
+        HierarchicalQueueOptions queue = default_queue_options();
+    };
+
+    // 局部队列较小且不自适应放大，窃取时比较所有局部队列的队首，优先级在各队列之间尽量保持
+    static HierarchicalQueueOptions default_queue_options()
+    {
+        HierarchicalQueueOptions options;
+        options.local_threshold = 16;
+        options.steal_policy = StealPolicy::best;
+        options.adaptive_threshold = false;
+        options.max_local_residence = std::chrono::milliseconds(1);
+        return options;
+    }
+
+private:
+    struct Entry
+    {
+        std::int64_t key = 0;        // 越大越先执行
+        std::uint64_t sequence = 0;  // 键相同时先提交的先执行
+        Task* task = nullptr;        // nullptr为工作线程的退出标记
+
+        bool operator<(const Entry& other) const noexcept
+        {
+            return key != other.key ? key < other.key : sequence > other.sequence;
+        }
+    };
+
+    const std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    const std::int64_t aging_ns_;
+    HierarchicalPriorityQueue<Entry> queue_;
+    std::atomic<std::uint64_t> sequence_{ 0 };
+    std::vector<std::thread> workers_;
+
+    static const PriorityExecutor*& current()
+    {
+        thread_local const PriorityExecutor* executor = nullptr;
+        return executor;
+    }
+
+public:
+    PriorityExecutor() : PriorityExecutor(Options{}) {}
+
+    explicit PriorityExecutor(std::size_t threads)
+        : PriorityExecutor(Options{ threads })
+    {
+    }
+
+    explicit PriorityExecutor(const Options& options)
+        : aging_ns_(std::max<std::int64_t>(0,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(options.aging_interval).count())),
+        queue_(options.queue)
+    {
+        workers_.reserve(options.threads);
+        for (std::size_t i = 0; i < options.threads; ++i)
+        {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    PriorityExecutor(const PriorityExecutor&) = delete;
+    PriorityExecutor& operator=(const PriorityExecutor&) = delete;
+
+    // 退出标记的优先级最低且不老化，排在所有剩余任务之后；工作线程全部退出后，残留在局部队列中的任务在此执行
+    ~PriorityExecutor()
+    {
+        for (std::size_t i = 0; i < workers_.size(); ++i)
+        {
+            queue_.push_global(Entry{ std::numeric_limits<std::int64_t>::min(), 0, nullptr });
+        }
+        for (auto& worker : workers_)
+        {
+            worker.join();
+        }
+        while (auto entry = queue_.try_pop())
+        {
+            run(entry->task);
+        }
+    }
+
+    // 工作线程数
+    std::size_t size() const noexcept { return workers_.size(); }
+
+    // 提交不关心结果的任务，任务不应抛出异常；没有工作线程时直接在当前线程执行
+    void post(int priority, Task task)
+    {
+        if (workers_.empty())
+        {
+            task();
+            return;
+        }
+
+        Entry entry{ key_for(priority), sequence_.fetch_add(1, std::memory_order_relaxed), new Task(std::move(task)) };
+        if (current() == this)
+        {
+            queue_.push(std::move(entry));
+        }
+        else
+        {
+            queue_.push_global(std::move(entry));
+        }
+    }
+
+    // 提交任务并通过future获取结果或异常
+    template <typename F>
+    auto submit(int priority, F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+    {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(func));
+        std::future<R> result = task->get_future();
+        post(priority, [task] { (*task)(); });
+        return result;
+    }
+
+private:
+    // 优先级项的上限：减去入队时刻（小于2^62纳秒）后仍大于int64最小值（退出标记）
+    static constexpr std::int64_t kMaxPriorityTerm = std::int64_t(1) << 62;
+
+    std::int64_t key_for(int priority) const
+    {
+        if (aging_ns_ == 0)
+        {
+            return priority;
+        }
+        const std::int64_t enqueued_at = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+        return priority_term(priority) - enqueued_at;
+    }
+
+    // priority * aging_ns_，饱和到[-kMaxPriorityTerm, kMaxPriorityTerm]
+    std::int64_t priority_term(int priority) const
+    {
+        const std::int64_t limit = kMaxPriorityTerm / aging_ns_;
+        if (priority > limit)
+        {
+            return kMaxPriorityTerm;
+        }
+        if (priority < -limit)
+        {
+            return -kMaxPriorityTerm;
+        }
+        return static_cast<std::int64_t>(priority) * aging_ns_;
+    }
+
+    static void run(Task* task)
+    {
+        if (task == nullptr)
+        {
+            return;
+        }
+        std::unique_ptr<Task> owned(task);
+        (*owned)();
+    }
+
+    void worker_loop()
+    {
+        current() = this;
+        while (true)
+        {
+            Entry entry = queue_.wait_and_pop();
+            if (entry.task == nullptr)
+            {
+                return;
+            }
+            run(entry.task);
+        }
+    }
+};
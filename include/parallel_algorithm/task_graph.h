@@ -0,0 +1,268 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <initializer_list>
+#include <cstddef>
+#include "thread_pool.h"
+
+/*
+任务图（DAG）执行器：节点声明依赖关系，运行时某个节点的全部前驱完成后立即在线程池上执行，
+不相关的阶段可以重叠，不必像逐个调用并行算法那样在每个阶段之间全局同步。
+- 图结构只在修改后第一次run时检查（有环时抛出std::logic_error）并计算拓扑序；之后重复run只需重置每个节点的
+  剩余前驱计数，不再分配内存，适合同一流水线反复执行。
+- 节点完成时递减后继的计数：最后一个就绪的后继在当前线程直接执行，其余的提交到线程池（工作线程提交的任务
+  进入自己的双端队列，数据在缓存中仍然是热的）。节点内部可以继续调用并行算法，等待时会帮忙执行其他任务。
+- 某个节点抛出异常后不再执行尚未开始的节点，run在全部节点结束后重新抛出第一个异常。
+- 每次run记录每个节点相对本次开始时刻的开始、结束时间，并按实测耗时计算关键路径（耗时之和最大的依赖链）。
+- 同一个图不能同时被多个线程run。
+*/
+class TaskGraph
+{
+public:
+    using NodeId = std::size_t;
+    using Duration = std::chrono::steady_clock::duration;
+
+    struct NodeTiming
+    {
+        Duration start{};      // 相对本次run开始的时刻
+        Duration finish{};
+        Duration path{};       // 以本节点结尾的最长依赖链耗时（含本节点）
+        bool critical = false; // 是否在关键路径上
+
+        Duration duration() const { return finish - start; }
+    };
+
+private:
+    struct Node
+    {
+        std::string name;
+        std::function<void()> work;
+        std::vector<NodeId> successors;
+        std::vector<NodeId> predecessors;
+        NodeTiming timing;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<NodeId> order_;                          // 拓扑序
+    std::vector<NodeId> sources_;                        // 没有前驱的节点
+    std::unique_ptr<std::atomic<std::size_t>[]> remaining_; // 每个节点尚未完成的前驱数
+    bool dirty_ = true;                                  // 图结构修改后需要重新检查
+
+    std::chrono::steady_clock::time_point run_start_;
+    Duration last_run_time_{};
+    std::vector<NodeId> critical_path_;
+    std::atomic<bool> failed_{ false };
+    std::exception_ptr error_;
+    std::mutex error_mutex_;
+
+public:
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // 添加节点，dependencies中的节点全部完成后才执行
+    NodeId add_node(std::string name, std::function<void()> work, std::initializer_list<NodeId> dependencies = {})
+    {
+        const NodeId id = nodes_.size();
+        nodes_.push_back(Node{ std::move(name), std::move(work), {}, {}, {} });
+        for (NodeId dependency : dependencies)
+        {
+            add_dependency(dependency, id);
+        }
+        dirty_ = true;
+        return id;
+    }
+
+    // 声明before完成后才能执行after
+    void add_dependency(NodeId before, NodeId after)
+    {
+        if (before >= nodes_.size() || after >= nodes_.size())
+        {
+            throw std::out_of_range("TaskGraph: unknown node");
+        }
+        nodes_[before].successors.push_back(after);
+        nodes_[after].predecessors.push_back(before);
+        dirty_ = true;
+    }
+
+    std::size_t size() const noexcept { return nodes_.size(); }
+    const std::string& name(NodeId id) const { return nodes_.at(id).name; }
+
+    // 最近一次run中各节点的时间
+    const NodeTiming& timing(NodeId id) const { return nodes_.at(id).timing; }
+
+    // 最近一次run的总耗时与关键路径（从源节点到汇节点的节点序列）
+    Duration last_run_time() const noexcept { return last_run_time_; }
+    const std::vector<NodeId>& critical_path() const noexcept { return critical_path_; }
+    Duration critical_path_time() const
+    {
+        return critical_path_.empty() ? Duration::zero() : nodes_[critical_path_.back()].timing.path;
+    }
+
+    // 执行整个图并等待全部节点结束，重新抛出第一个异常
+    void run(ThreadPool& pool = default_thread_pool())
+    {
+        prepare();
+        for (NodeId id = 0; id < nodes_.size(); ++id)
+        {
+            remaining_[id].store(nodes_[id].predecessors.size(), std::memory_order_relaxed);
+            nodes_[id].timing = NodeTiming{};
+        }
+        failed_.store(false, std::memory_order_relaxed);
+        error_ = nullptr;
+
+        run_start_ = std::chrono::steady_clock::now();
+        {
+            TaskGroup group(pool);
+            for (NodeId source : sources_)
+            {
+                group.run([this, &group, source] { execute(group, source); });
+            }
+            group.wait();
+        }
+        last_run_time_ = std::chrono::steady_clock::now() - run_start_;
+        compute_critical_path();
+
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    // 检查是否有环并计算拓扑序（Kahn算法），只在图结构修改后执行
+    void prepare()
+    {
+        if (!dirty_)
+        {
+            return;
+        }
+        const std::size_t n = nodes_.size();
+        std::vector<std::size_t> in_degree(n);
+        sources_.clear();
+        order_.clear();
+        order_.reserve(n);
+        for (NodeId id = 0; id < n; ++id)
+        {
+            in_degree[id] = nodes_[id].predecessors.size();
+            if (in_degree[id] == 0)
+            {
+                sources_.push_back(id);
+                order_.push_back(id);
+            }
+        }
+        for (std::size_t i = 0; i < order_.size(); ++i)
+        {
+            for (NodeId next : nodes_[order_[i]].successors)
+            {
+                if (--in_degree[next] == 0)
+                {
+                    order_.push_back(next);
+                }
+            }
+        }
+        if (order_.size() != n)
+        {
+            throw std::logic_error("TaskGraph: dependency cycle");
+        }
+        remaining_ = std::make_unique<std::atomic<std::size_t>[]>(n);
+        dirty_ = false;
+    }
+
+    // 执行一个节点，然后继续执行它变为就绪的后继：最后一个就绪的后继留在当前线程，其余提交到线程池
+    void execute(TaskGroup& group, NodeId id)
+    {
+        while (true)
+        {
+            Node& node = nodes_[id];
+            node.timing.start = std::chrono::steady_clock::now() - run_start_;
+            if (!failed_.load(std::memory_order_acquire))
+            {
+                try
+                {
+                    node.work();
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(error_mutex_);
+                    if (!error_)
+                    {
+                        error_ = std::current_exception();
+                    }
+                    failed_.store(true, std::memory_order_release);
+                }
+            }
+            node.timing.finish = std::chrono::steady_clock::now() - run_start_;
+
+            bool has_next = false;
+            NodeId next = 0;
+            for (NodeId successor : node.successors)
+            {
+                if (remaining_[successor].fetch_sub(1, std::memory_order_acq_rel) != 1)
+                {
+                    continue;
+                }
+                if (has_next)
+                {
+                    group.run([this, &group, ready = next] { execute(group, ready); });
+                }
+                next = successor;
+                has_next = true;
+            }
+            if (!has_next)
+            {
+                return;
+            }
+            id = next;
+        }
+    }
+
+    // 按拓扑序计算以每个节点结尾的最长依赖链，并回溯出关键路径
+    void compute_critical_path()
+    {
+        critical_path_.clear();
+        if (nodes_.empty())
+        {
+            return;
+        }
+        std::vector<NodeId> via(nodes_.size());
+        NodeId last = order_.front();
+        for (NodeId id : order_)
+        {
+            Node& node = nodes_[id];
+            Duration longest{};
+            via[id] = id;
+            for (NodeId predecessor : node.predecessors)
+            {
+                if (nodes_[predecessor].timing.path > longest)
+                {
+                    longest = nodes_[predecessor].timing.path;
+                    via[id] = predecessor;
+                }
+            }
+            node.timing.path = longest + node.timing.duration();
+            if (node.timing.path > nodes_[last].timing.path)
+            {
+                last = id;
+            }
+        }
+        for (NodeId id = last; ; id = via[id])
+        {
+            critical_path_.push_back(id);
+            nodes_[id].timing.critical = true;
+            if (via[id] == id)
+            {
+                break;
+            }
+        }
+        std::reverse(critical_path_.begin(), critical_path_.end());
+    }
+};
@@ -0,0 +1,188 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <thread>
+#include <cstddef>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/*
+CPU拓扑探测与线程绑核，供线程池按NUMA节点放置工作线程。
+- Linux上从/sys/devices/system/node读取每个NUMA节点的CPU列表，并与当前进程允许使用的CPU（sched_getaffinity）取交集；
+  读取失败或其他平台上视为只有一个节点，包含0~hardware_concurrency()-1。
+- 绑核只在Linux上生效（pthread_setaffinity_np），其他平台上pin_current_thread什么也不做并返回false。
+*/
+enum class affinity_policy
+{
+    none,       // 不绑核，由操作系统调度
+    compact,    // 依次占满一个节点的CPU再使用下一个节点（共享缓存，适合通信多的任务）
+    scatter,    // 工作线程轮流分布到各节点（聚合所有节点的内存带宽）
+    numa_node   // 工作线程按编号分段分配到各节点，只绑定到节点而不绑定具体CPU
+};
+
+struct cpu_topology
+{
+    std::vector<std::vector<int>> nodes;  // 每个NUMA节点可用的逻辑CPU编号（升序）
+
+    std::size_t cpu_count() const
+    {
+        std::size_t count = 0;
+        for (const auto& node : nodes)
+        {
+            count += node.size();
+        }
+        return count;
+    }
+
+    // 解析内核的CPU列表格式，例如"0-3,8-11"
+    static std::vector<int> parse_cpu_list(const std::string& text)
+    {
+        std::vector<int> cpus;
+        std::stringstream stream(text);
+        std::string range;
+        while (std::getline(stream, range, ','))
+        {
+            if (range.find_first_of("0123456789") == std::string::npos)
+            {
+                continue;
+            }
+            const std::size_t dash = range.find('-');
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    // 当前机器的拓扑，首次调用时探测
+    static const cpu_topology& current()
+    {
+        static const cpu_topology topology = detect();
+        return topology;
+    }
+
+private:
+    static cpu_topology detect()
+    {
+        cpu_topology topology;
+#if defined(__linux__)
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        const bool has_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+        auto usable = [&](int cpu) { return !has_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)); };
+
+        std::vector<std::pair<int, std::vector<int>>> found;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec))
+        {
+            const std::string name = entry.path().filename().string();
+            if (name.rfind("node", 0) != 0 || name.size() == 4
+                || name.find_first_not_of("0123456789", 4) != std::string::npos)
+            {
+                continue;
+            }
+            std::ifstream file(entry.path() / "cpulist");
+            std::string text;
+            std::getline(file, text);
+            std::vector<int> cpus = parse_cpu_list(text);
+            cpus.erase(std::remove_if(cpus.begin(), cpus.end(), [&](int cpu) { return !usable(cpu); }), cpus.end());
+            if (!cpus.empty())
+            {
+                found.emplace_back(std::stoi(name.substr(4)), std::move(cpus));
+            }
+        }
+        std::sort(found.begin(), found.end());
+        for (auto& node : found)
+        {
+            topology.nodes.push_back(std::move(node.second));
+        }
+
+        if (topology.nodes.empty() && has_mask)
+        {
+            std::vector<int> cpus;
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+            }
+            if (!cpus.empty()) topology.nodes.push_back(std::move(cpus));
+        }
+#endif
+        if (topology.nodes.empty())
+        {
+            std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+            for (std::size_t i = 0; i < cpus.size(); ++i) cpus[i] = static_cast<int>(i);
+            topology.nodes.push_back(std::move(cpus));
+        }
+        return topology;
+    }
+};
+
+// 按策略计算workers个工作线程各自可运行的CPU集合（none时全部为空，表示不绑核）
+inline std::vector<std::vector<int>> worker_placement(
+    const cpu_topology& topology, affinity_policy policy, std::size_t workers)
+{
+    std::vector<std::vector<int>> placement(workers);
+    const std::size_t node_count = topology.nodes.size();
+    if (policy == affinity_policy::none || node_count == 0 || topology.cpu_count() == 0)
+    {
+        return placement;
+    }
+
+    std::vector<int> flat;
+    for (const auto& node : topology.nodes)
+    {
+        flat.insert(flat.end(), node.begin(), node.end());
+    }
+
+    for (std::size_t i = 0; i < workers; ++i)
+    {
+        switch (policy)
+        {
+        case affinity_policy::compact:
+            placement[i] = { flat[i % flat.size()] };
+            break;
+        case affinity_policy::scatter:
+        {
+            const auto& node = topology.nodes[i % node_count];
+            placement[i] = { node[(i / node_count) % node.size()] };
+            break;
+        }
+        case affinity_policy::numa_node:
+            placement[i] = topology.nodes[i * node_count / workers];
+            break;
+        default:
+            break;
+        }
+    }
+    return placement;
+}
+
+// 把当前线程绑定到cpus中的CPU上，成功返回true
+inline bool pin_current_thread(const std::vector<int>& cpus)
+{
+#if defined(__linux__)
+    if (cpus.empty())
+    {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+    {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
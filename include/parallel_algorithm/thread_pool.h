@@ -0,0 +1,834 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <random>
+#include <exception>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <chrono>
+#include <stdexcept>
+#include <thread_safe_queue/work_stealing_deque.h>
+#include "thread_affinity.h"
+
+/*
+进程级共享的工作窃取线程池（fork-join调度器），所有并行算法默认通过default_thread_pool()执行，
+避免每次调用都创建、销毁线程（创建一个线程约需数十微秒，小规模输入时远超计算本身）。
+- 每个工作线程有自己的Chase-Lev双端队列：工作线程内提交的任务压入自己队列的底部并优先从底部取回（后进先出，
+  缓存友好）；空闲时先取外部提交队列，再随机选择其他工作线程从其队列顶部窃取（拿走最早、通常最大的任务）。
+- 非工作线程提交的任务进入一个加锁的外部提交队列。
+- 工作线程数默认为硬件线程数减一：发起并行算法的线程在等待时也会执行任务，合起来正好占满所有核心；
+  单核机器上没有工作线程，任务直接在提交线程中执行。
+- TaskGroup的run/wait即spawn/sync：等待子任务时不阻塞，而是优先执行自己队列中的任务、再去窃取（帮助式join），
+  因此递归算法可以任意拆分任务而不会因任务互相等待而死锁，由运行时负责负载均衡。
+- 每个并行算法都提供以ThreadPool&为第一个参数的重载，用于指定执行器（例如隔离不同子系统的负载）。
+- 可按affinity_policy把工作线程绑定到CPU或NUMA节点；post_to提交的任务只由指定的工作线程执行，
+  配合绑核可让同一块数据总在同一节点上初始化与处理（首次访问决定内存页所在的节点）。
+- 以Sizing构造时线程数在[min_threads, max_threads]之间动态变化（适合突发负载）：提交任务时若排队任务过多就增加一个工作线程；
+  另有一个监视线程在有任务排队时定时检查，已有任务排队却超过max_latency没有任务被取走（现有线程都被占住）时也增加一个工作线程，
+  因此突发后不再提交任务时，排队的任务也不会一直等到占住线程的任务结束；空闲超过keep_alive的工作线程退出。
+  工作线程的队列按max_threads预先分配（窃取时访问的队列数组不变），线程只在这些位置上启动和退出。
+- 启动开销：lazy_start时构造函数不创建线程，第一次提交任务时才启动（不一定会用到并行的短命令行进程不必付出创建线程的代价）；
+  warm_up()预先启动全部工作线程并在每个线程上触碰栈与一块堆内存（建立线程的malloc arena、提前完成缺页），
+  常驻服务在启动阶段调用，第一次请求就不再承担这些开销。
+*/
+class ThreadPool
+{
+public:
+    // 动态线程数的上下限与伸缩条件
+    struct Sizing
+    {
+        std::size_t min_threads = 0;
+        std::size_t max_threads = default_thread_count();
+        std::size_t backlog_per_worker = 2;             // 排队任务数超过 活跃工作线程数 * backlog_per_worker 时增加线程
+        std::chrono::microseconds max_latency{ 2000 };  // 有任务排队且超过这么久没有任务被取走时增加线程（由监视线程定时检查）
+        std::chrono::milliseconds keep_alive{ 1000 };   // 连续空闲超过这么久的工作线程退出（至少保留min_threads个）
+        bool lazy_start = false;                        // 构造时不启动线程，第一次提交任务时再启动min_threads个
+    };
+
+    // warm_up在每个工作线程上预先触碰的内存量
+    struct WarmUp
+    {
+        std::size_t stack_bytes = 64 * 1024;     // 栈空间（递归算法的调用栈）
+        std::size_t scratch_bytes = 1 << 20;     // 堆内存（分配、逐页写入后释放，算法的临时缓冲区随后可复用）
+    };
+
+private:
+    using Task = std::function<void()>;
+
+    struct Worker
+    {
+        WorkStealingDeque<Task*> deque;
+        std::deque<Task*> mailbox;        // post_to指定给本线程的任务，不可被窃取
+        std::mutex mailbox_mutex;
+        std::vector<int> cpus;            // 绑定的CPU，空表示不绑核
+        std::thread thread;
+        bool running = false;             // 本位置是否有运行中的线程（同时持有lifecycle_mutex_与mailbox_mutex时修改）
+    };
+
+    // 当前线程所属的线程池与工作线程下标（非工作线程为nullptr）
+    struct WorkerContext
+    {
+        const ThreadPool* pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    static WorkerContext& context()
+    {
+        thread_local WorkerContext ctx;
+        return ctx;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::deque<Task*> injected_;          // 外部线程提交的任务
+    std::mutex injected_mutex_;
+
+    // 休眠协议：提交任务或任务组完成时递增epoch_；线程休眠前记录epoch_，确认期间没有变化才等待
+    std::atomic<std::uint64_t> epoch_{ 0 };
+    std::atomic<std::size_t> sleepers_{ 0 };
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<bool> stop_{ false };
+
+    // 动态线程数（min_threads < max_threads时启用，固定大小的线程池不维护下面的计数）
+    const Sizing sizing_;
+    const bool dynamic_;
+    std::mutex lifecycle_mutex_;                 // 启动、退出工作线程
+    std::atomic<std::size_t> active_{ 0 };       // 运行中的工作线程数
+    std::atomic<std::size_t> queued_{ 0 };       // 已提交、尚未被取走的任务数
+    std::atomic<std::int64_t> last_take_{ 0 };   // 最近一次取走任务（或队列由空变为非空）的时刻，steady_clock计数
+    std::atomic<std::size_t> spawned_{ 0 };
+    std::atomic<std::size_t> retired_{ 0 };
+    std::atomic<std::size_t> idle_timeouts_{ 0 };
+    std::atomic<bool> started_{ false };         // 是否已启动min_threads个工作线程（lazy_start时推迟到第一次提交）
+
+    // 延迟监视线程（仅动态线程池）：有任务排队时按max_latency定时检查，队列为空时休眠直到队列由空变为非空
+    std::thread monitor_;
+    std::mutex monitor_mutex_;
+    std::condition_variable monitor_cv_;
+    std::atomic<bool> monitor_idle_{ false };    // 监视线程正在等待队列变为非空
+
+    friend class TaskGroup;
+
+public:
+    explicit ThreadPool(std::size_t threads = default_thread_count(),
+        affinity_policy affinity = affinity_policy::none)
+        : ThreadPool(Sizing{ threads, threads }, affinity)
+    {
+    }
+
+    explicit ThreadPool(const Sizing& sizing, affinity_policy affinity = affinity_policy::none)
+        : sizing_(sizing), dynamic_(sizing.min_threads < sizing.max_threads)
+    {
+        if (sizing.min_threads > sizing.max_threads)
+        {
+            throw std::invalid_argument("ThreadPool: min_threads must not exceed max_threads");
+        }
+        const std::size_t slots = sizing.max_threads;
+        auto placement = worker_placement(cpu_topology::current(), affinity, slots);
+        workers_.reserve(slots);
+        for (std::size_t i = 0; i < slots; ++i)
+        {
+            workers_.push_back(std::make_unique<Worker>());
+            workers_[i]->cpus = std::move(placement[i]);
+        }
+        // 全部队列建好后再启动线程，工作线程窃取时会访问所有队列
+        if (!sizing.lazy_start)
+        {
+            start();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 先执行完所有剩余任务，再回收工作线程（包括已退出、尚未回收的线程）
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_.store(true);
+        }
+        sleep_cv_.notify_all();
+        {
+            std::lock_guard<std::mutex> lock(monitor_mutex_);
+        }
+        monitor_cv_.notify_all();
+        if (monitor_.joinable())
+        {
+            monitor_.join();
+        }
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+            for (auto& worker : workers_)
+            {
+                if (worker->thread.joinable())
+                {
+                    threads.push_back(std::move(worker->thread));
+                }
+            }
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    static std::size_t default_thread_count()
+    {
+        const std::size_t hardware_threads = std::thread::hardware_concurrency();
+        return hardware_threads > 1 ? hardware_threads - 1 : 0;
+    }
+
+    // 工作线程数（动态线程池为上限max_threads）
+    std::size_t size() const noexcept { return workers_.size(); }
+
+    // 当前运行中的工作线程数，以及累计启动、退出的工作线程数（固定大小的线程池只统计构造时启动的线程）
+    std::size_t active_workers() const noexcept { return active_.load(); }
+    std::size_t spawned_workers() const noexcept { return spawned_.load(); }
+    std::size_t retired_workers() const noexcept { return retired_.load(); }
+
+    // 动态线程池中工作线程空闲等待超时的累计次数：每个空闲线程每keep_alive最多一次
+    std::size_t idle_timeouts() const noexcept { return idle_timeouts_.load(std::memory_order_relaxed); }
+
+    // 一次并行调用可同时执行的任务数：工作线程加上等待中的调用线程
+    std::size_t concurrency() const noexcept { return workers_.size() + 1; }
+
+    // 第index个工作线程绑定的CPU（空表示不绑核）
+    const std::vector<int>& worker_cpus(std::size_t index) const { return workers_[index]->cpus; }
+
+    // 当前线程在本线程池中的工作线程编号，非本线程池的工作线程返回std::nullopt
+    std::optional<std::size_t> current_worker() const noexcept
+    {
+        const WorkerContext& ctx = context();
+        if (ctx.pool != this) return std::nullopt;
+        return ctx.index;
+    }
+
+    // 启动全部工作线程（动态线程池启动到max_threads，之后空闲的线程照常按keep_alive退出），
+    // 并在每个工作线程上触碰栈和堆内存，全部完成后返回。
+    // 可以在本线程池的工作线程中调用：调用线程直接在自己身上触碰内存，等待其他线程期间照常执行任务
+    // （包括其他线程同时调用warm_up时指定给它的任务），不会死锁
+    void warm_up() { warm_up(WarmUp{}); }
+
+    void warm_up(const WarmUp& options)
+    {
+        start();
+        {
+            std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+            for (std::size_t i = 0; i < workers_.size(); ++i)
+            {
+                start_worker(i);
+            }
+        }
+        const std::optional<std::size_t> self = current_worker();
+        std::atomic<std::size_t> remaining{ workers_.size() - (self ? 1 : 0) };
+        for (std::size_t i = 0; i < workers_.size(); ++i)
+        {
+            if (self && *self == i)
+            {
+                continue;
+            }
+            post_to(i, [this, &remaining, options] {
+                touch_memory(options);
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    signal(true);
+                }
+                });
+        }
+        if (self)
+        {
+            touch_memory(options);
+        }
+        help_until([&remaining] { return remaining.load(std::memory_order_acquire) == 0; });
+    }
+
+    // 提交不关心结果的任务，任务不应抛出异常；没有工作线程时直接在当前线程执行
+    void post(Task task)
+    {
+        if (workers_.empty())
+        {
+            task();
+            return;
+        }
+        if (!started_.load(std::memory_order_acquire))
+        {
+            start();
+        }
+
+        Task* job = new Task(std::move(task));
+        if (dynamic_)
+        {
+            note_queued();
+        }
+        const WorkerContext& ctx = context();
+        if (ctx.pool == this)
+        {
+            workers_[ctx.index]->deque.push(job);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(injected_mutex_);
+            injected_.push_back(job);
+        }
+        signal(false);
+        if (dynamic_)
+        {
+            maybe_grow();
+        }
+    }
+
+    // 提交只由第worker % size()个工作线程执行的任务（不参与窃取），该线程已退出时重新启动它；
+    // 没有工作线程时直接在当前线程执行
+    void post_to(std::size_t worker, Task task)
+    {
+        if (workers_.empty())
+        {
+            task();
+            return;
+        }
+
+        const std::size_t index = worker % workers_.size();
+        Worker& target = *workers_[index];
+        bool running = false;
+        if (dynamic_)
+        {
+            note_queued();
+        }
+        {
+            std::lock_guard<std::mutex> lock(target.mailbox_mutex);
+            target.mailbox.push_back(new Task(std::move(task)));
+            running = target.running;
+        }
+        if (!running)
+        {
+            std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+            start_worker(index);
+        }
+        signal(true);  // 只有目标线程能执行，唤醒全部以确保它被唤醒
+    }
+
+    // 提交任务并通过future获取结果或异常
+    template <typename F>
+    auto submit(F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+    {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(func));
+        std::future<R> result = task->get_future();
+        post([task] { (*task)(); });
+        return result;
+    }
+
+    // 在当前线程执行一个待执行的任务（自己的队列、外部提交队列或窃取），没有任务时返回false
+    bool try_run_one()
+    {
+        Task* job = find_task();
+        if (job == nullptr)
+        {
+            return false;
+        }
+        run(job);
+        return true;
+    }
+
+private:
+    static void run(Task* job)
+    {
+        std::unique_ptr<Task> owned(job);
+        (*owned)();
+    }
+
+    void worker_loop(std::size_t index)
+    {
+        context() = WorkerContext{ this, index };
+        pin_current_thread(workers_[index]->cpus);
+        auto idle_until = std::chrono::steady_clock::now() + sizing_.keep_alive;
+        while (true)
+        {
+            const std::uint64_t seen = epoch_.load();
+            if (Task* job = find_task())
+            {
+                run(job);
+                if (dynamic_)
+                {
+                    idle_until = std::chrono::steady_clock::now() + sizing_.keep_alive;
+                }
+                continue;
+            }
+            if (stop_.load())
+            {
+                return;  // 已停止且没有剩余任务
+            }
+            if (!dynamic_)
+            {
+                sleep(seen, [] { return false; });
+            }
+            else if (!sleep_until(seen, idle_until))
+            {
+                idle_timeouts_.fetch_add(1, std::memory_order_relaxed);
+                if (retire(index, seen))
+                {
+                    return;
+                }
+                // 未能退出（已是min_threads个或期间有新任务）：重新开始计时，否则之后每次休眠都立即超时，线程空转
+                idle_until = std::chrono::steady_clock::now() + sizing_.keep_alive;
+            }
+        }
+    }
+
+    // 启动min_threads个工作线程（构造时，或lazy_start时第一次提交任务时）
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+        if (started_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        for (std::size_t i = 0; i < sizing_.min_threads; ++i)
+        {
+            start_worker(i);
+        }
+        if (dynamic_ && !workers_.empty())
+        {
+            monitor_ = std::thread([this] { monitor_loop(); });
+        }
+        started_.store(true, std::memory_order_release);
+    }
+
+    // 监视线程：排队任务超过max_latency没有被取走时调用maybe_grow。
+    // 工作线程都在执行阻塞任务时没有线程会回到调度循环，只在post中检查会让排队任务一直等到下一次提交
+    void monitor_loop()
+    {
+        using clock = std::chrono::steady_clock;
+        const auto latency = std::chrono::duration_cast<clock::duration>(sizing_.max_latency);
+        // 已达上限（或刚启动的线程尚未取走任务）时按该间隔重新检查，max_latency为0时也不会空转
+        const auto recheck = std::max<clock::duration>(latency, std::chrono::microseconds(100));
+        const auto stopped = [this] { return stop_.load(); };
+        std::unique_lock<std::mutex> lock(monitor_mutex_);
+        while (!stop_.load())
+        {
+            if (queued_.load() == 0)
+            {
+                // 先置位monitor_idle_再读queued_，与note_queued中先递增queued_再读monitor_idle_配对（都为seq_cst）
+                monitor_idle_.store(true);
+                monitor_cv_.wait(lock, [this] { return stop_.load() || queued_.load() > 0; });
+                monitor_idle_.store(false);
+                continue;
+            }
+            const clock::time_point due = clock::time_point(clock::duration(last_take_.load(std::memory_order_relaxed))) + latency;
+            if (clock::now() < due)
+            {
+                monitor_cv_.wait_until(lock, due, stopped);
+                continue;
+            }
+            lock.unlock();
+            maybe_grow();
+            lock.lock();
+            monitor_cv_.wait_for(lock, recheck, stopped);
+        }
+    }
+
+    static void touch_memory(const WarmUp& options)
+    {
+        touch_stack(options.stack_bytes / 4096 + 1);
+        touch_heap(options.scratch_bytes);
+    }
+
+    // 逐页写入pages页栈空间（每层递归占用一页，递归返回后再次访问，避免被优化为尾调用）
+    static void touch_stack(std::size_t pages)
+    {
+        volatile char page[4096];
+        page[0] = 0;
+        page[sizeof(page) - 1] = 0;
+        if (pages > 1)
+        {
+            touch_stack(pages - 1);
+        }
+        page[1] = page[0];
+    }
+
+    // 分配并逐页写入bytes字节堆内存后释放
+    static void touch_heap(std::size_t bytes)
+    {
+        if (bytes == 0)
+        {
+            return;
+        }
+        std::unique_ptr<char[]> scratch(new char[bytes]);
+        volatile char* memory = scratch.get();
+        for (std::size_t offset = 0; offset < bytes; offset += 4096)
+        {
+            memory[offset] = 0;
+        }
+    }
+
+    // 动态线程池：排队任务过多，或有任务排队却超过max_latency没有任务被取走时，启动一个工作线程
+    void maybe_grow()
+    {
+        const std::size_t active = active_.load();
+        if (active >= workers_.size())
+        {
+            return;
+        }
+        const std::size_t queued = queued_.load(std::memory_order_relaxed);
+        const bool starving = queued > 0 && now_ticks() - last_take_.load(std::memory_order_relaxed)
+            > std::chrono::duration_cast<std::chrono::steady_clock::duration>(sizing_.max_latency).count();
+        if (active == 0 || queued > active * sizing_.backlog_per_worker || starving)
+        {
+            std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+            for (std::size_t i = 0; i < workers_.size(); ++i)
+            {
+                if (!workers_[i]->running)
+                {
+                    start_worker(i);
+                    break;
+                }
+            }
+        }
+    }
+
+    // 在第index个位置启动工作线程（调用者持有lifecycle_mutex_），之前退出的线程先回收
+    void start_worker(std::size_t index)
+    {
+        Worker& worker = *workers_[index];
+        if (worker.running || stop_.load())
+        {
+            return;
+        }
+        if (worker.thread.joinable())
+        {
+            worker.thread.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(worker.mailbox_mutex);
+            worker.running = true;
+        }
+        active_.fetch_add(1);
+        spawned_.fetch_add(1, std::memory_order_relaxed);
+        worker.thread = std::thread([this, index] { worker_loop(index); });
+    }
+
+    // 空闲超时的工作线程尝试退出：保留min_threads个；自己的队列已空，但指定给自己的任务未取完时不退出；
+    // 先减少active_再检查epoch_，与post中先递增epoch_再读取active_配对（都为seq_cst），
+    // 因此要么这里看到新提交的任务而放弃退出，要么提交者看到线程数减少而启动新线程
+    bool retire(std::size_t index, std::uint64_t seen)
+    {
+        std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+        if (stop_.load() || active_.load() <= sizing_.min_threads)
+        {
+            return false;
+        }
+        Worker& self = *workers_[index];
+        std::lock_guard<std::mutex> mailbox_lock(self.mailbox_mutex);
+        if (!self.mailbox.empty())
+        {
+            return false;
+        }
+        active_.fetch_sub(1);
+        if (epoch_.load() != seen)
+        {
+            active_.fetch_add(1);
+            return false;
+        }
+        self.running = false;
+        retired_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 队列由空变为非空时从当前时刻开始计算等待时间，并唤醒等待中的监视线程
+    void note_queued()
+    {
+        if (queued_.fetch_add(1) == 0)
+        {
+            last_take_.store(now_ticks(), std::memory_order_relaxed);
+            if (monitor_idle_.load())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(monitor_mutex_);
+                }
+                monitor_cv_.notify_one();
+            }
+        }
+    }
+
+    static std::int64_t now_ticks()
+    {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    // 取走一个待执行的任务，动态线程池同时更新排队计数与最近取走任务的时刻
+    Task* find_task()
+    {
+        Task* job = find_any_task();
+        if (job != nullptr && dynamic_)
+        {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            last_take_.store(now_ticks(), std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // 查找顺序：自己队列底部 -> 指定给自己的任务 -> 外部提交队列 -> 从随机位置开始依次窃取其他队列顶部
+    Task* find_any_task()
+    {
+        const WorkerContext& ctx = context();
+        const bool is_worker = ctx.pool == this;
+        if (is_worker)
+        {
+            Worker& self = *workers_[ctx.index];
+            if (auto job = self.deque.pop())
+            {
+                return *job;
+            }
+            std::lock_guard<std::mutex> lock(self.mailbox_mutex);
+            if (!self.mailbox.empty())
+            {
+                Task* job = self.mailbox.front();
+                self.mailbox.pop_front();
+                return job;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(injected_mutex_);
+            if (!injected_.empty())
+            {
+                Task* job = injected_.front();
+                injected_.pop_front();
+                return job;
+            }
+        }
+
+        const std::size_t n = workers_.size();
+        if (n == 0)
+        {
+            return nullptr;
+        }
+        thread_local std::minstd_rand gen(static_cast<unsigned>(
+            std::hash<std::thread::id>{}(std::this_thread::get_id())));
+        const std::size_t start = gen() % n;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const std::size_t victim = (start + i) % n;
+            if (is_worker && victim == ctx.index)
+            {
+                continue;
+            }
+            if (auto job = workers_[victim]->deque.steal())
+            {
+                return *job;
+            }
+        }
+        return nullptr;
+    }
+
+    // 近似判断是否还有可执行的任务
+    bool has_visible_work()
+    {
+        {
+            std::lock_guard<std::mutex> lock(injected_mutex_);
+            if (!injected_.empty()) return true;
+        }
+        for (auto& worker : workers_)
+        {
+            if (!worker->deque.empty()) return true;
+        }
+        return false;
+    }
+
+    // 有新任务时唤醒一个休眠线程，任务组完成时唤醒全部（等待者各自检查自己的任务组）
+    void signal(bool all)
+    {
+        epoch_.fetch_add(1);
+        if (sleepers_.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            if (all)
+            {
+                sleep_cv_.notify_all();
+            }
+            else
+            {
+                sleep_cv_.notify_one();
+            }
+        }
+    }
+
+    // seen为查找任务之前读取的epoch_：期间有新任务或任务组完成则不休眠
+    // （epoch_与sleepers_都使用seq_cst：提交者先递增epoch_再读sleepers_，休眠者先递增sleepers_再读epoch_，
+    // 两者至少有一方看到对方的修改，因此不会丢失唤醒）
+    template <typename Pred>
+    void sleep(std::uint64_t seen, Pred done)
+    {
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleepers_.fetch_add(1);
+        sleep_cv_.wait(lock, [&] { return epoch_.load() != seen || stop_.load() || done(); });
+        sleepers_.fetch_sub(1);
+    }
+
+    // 同sleep，但最多等到deadline，超时返回false
+    bool sleep_until(std::uint64_t seen, std::chrono::steady_clock::time_point deadline)
+    {
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleepers_.fetch_add(1);
+        const bool woken = sleep_cv_.wait_until(lock, deadline, [&] { return epoch_.load() != seen || stop_.load(); });
+        sleepers_.fetch_sub(1);
+        return woken;
+    }
+
+    // 等待done()成立，期间执行自己队列中的任务或窃取其他任务
+    template <typename Pred>
+    void help_until(Pred done)
+    {
+        while (!done())
+        {
+            const std::uint64_t seen = epoch_.load();
+            if (Task* job = find_task())
+            {
+                run(job);
+                continue;
+            }
+            sleep(seen, done);
+        }
+        // 被有新任务的notify_one唤醒却已无需等待时，把通知转交给其他线程，避免任务无人执行
+        if (sleepers_.load() > 0 && has_visible_work())
+        {
+            signal(false);
+        }
+    }
+};
+
+// 进程级共享线程池，首次使用时创建
+inline ThreadPool& default_thread_pool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+// 一组在线程池上执行的任务：run（spawn）提交任务，wait（sync）等待全部完成并重新抛出第一个异常
+class TaskGroup
+{
+private:
+    ThreadPool& pool_;
+    std::atomic<std::size_t> pending_{ 0 };
+    std::exception_ptr error_;
+    std::mutex error_mutex_;
+
+public:
+    explicit TaskGroup(ThreadPool& pool = default_thread_pool()) : pool_(pool) {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // 任务可能引用调用者栈上的数据，析构前必须等待全部完成
+    ~TaskGroup()
+    {
+        pool_.help_until([this] { return pending_.load(std::memory_order_acquire) == 0; });
+    }
+
+    template <typename F>
+    void run(F&& func)
+    {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool_.post(wrap(std::forward<F>(func)));
+    }
+
+    // 提交只由第worker % size()个工作线程执行的任务（见ThreadPool::post_to）
+    template <typename F>
+    void run_on(std::size_t worker, F&& func)
+    {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool_.post_to(worker, wrap(std::forward<F>(func)));
+    }
+
+    void wait()
+    {
+        pool_.help_until([this] { return pending_.load(std::memory_order_acquire) == 0; });
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            error = std::exchange(error_, nullptr);
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    template <typename F>
+    auto wrap(F&& func)
+    {
+        return [this, func = std::forward<F>(func)]() mutable {
+            try
+            {
+                func();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex_);
+                if (!error_)
+                {
+                    error_ = std::current_exception();
+                }
+            }
+            finish_one();
+            };
+    }
+
+    void finish_one()
+    {
+        // 计数归零后等待者可能立即返回并销毁本对象，因此先取出线程池引用
+        ThreadPool& pool = pool_;
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            pool.signal(true);
+        }
+    }
+};
+
+// fork-join：并行执行所有函数，第一个在当前线程执行，全部完成后返回，重新抛出第一个异常
+template <typename F, typename... Fs>
+void parallel_invoke(ThreadPool& pool, F&& first, Fs&&... rest)
+{
+    TaskGroup group(pool);
+    (group.run(std::forward<Fs>(rest)), ...);
+    std::exception_ptr error;
+    try
+    {
+        std::forward<F>(first)();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    try
+    {
+        group.wait();
+    }
+    catch (...)
+    {
+        if (!error) error = std::current_exception();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename F, typename... Fs>
+    requires (!std::is_same_v<std::decay_t<F>, ThreadPool>)
+void parallel_invoke(F&& first, Fs&&... rest)
+{
+    parallel_invoke(default_thread_pool(), std::forward<F>(first), std::forward<Fs>(rest)...);
+}
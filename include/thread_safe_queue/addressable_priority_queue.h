@@ -0,0 +1,276 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+/*
+可寻址的线程安全优先级队列（索引堆）。
+push返回句柄，之后可以通过句柄在O(log n)内修改优先级或删除元素，
+调度器重新调整任务优先级时不必再压入重复元素、出队时过滤过期元素，堆大小始终等于存活元素数量。
+元素本身存放在槽位数组中，堆里只保存槽位下标，每个槽位记录自己在堆中的位置。
+*/
+
+// 元素句柄：槽位下标 + 版本号。槽位被复用后版本号递增，旧句柄自动失效
+struct PriorityQueueHandle
+{
+    std::uint32_t slot = UINT32_MAX;
+    std::uint32_t generation = 0;
+
+    bool operator==(const PriorityQueueHandle& other) const
+    {
+        return slot == other.slot && generation == other.generation;
+    }
+};
+
+template <
+    typename T,
+    typename Priority = int,
+    typename Compare = std::less<Priority>
+>
+class AddressablePriorityQueue
+{
+public:
+    using Handle = PriorityQueueHandle;
+
+private:
+    struct Slot
+    {
+        std::optional<T> value;        // 元素数据（空表示槽位空闲）
+        Priority priority{};           // 元素优先级
+        size_t heap_index = 0;         // 元素在堆数组中的位置
+        std::uint32_t generation = 0;  // 槽位版本号
+    };
+
+    std::vector<Slot> slots_;          // 槽位数组
+    std::vector<std::uint32_t> heap_;  // 堆数组，保存槽位下标
+    std::vector<std::uint32_t> free_slots_;  // 空闲槽位（复用以保持槽位数组紧凑）
+    Compare comp_;
+    mutable std::mutex mutex_;         // 保护以上所有数据
+    std::condition_variable cond_var_; // 通知消费者有元素可用
+
+public:
+    AddressablePriorityQueue() = default;
+    explicit AddressablePriorityQueue(const Compare& comp) : comp_(comp) {}
+
+    // 禁止拷贝（线程安全对象通常不可拷贝）
+    AddressablePriorityQueue(const AddressablePriorityQueue&) = delete;
+    AddressablePriorityQueue& operator=(const AddressablePriorityQueue&) = delete;
+
+    // 入队：返回元素句柄
+    Handle push(T value, Priority priority)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::uint32_t slot;
+        if (!free_slots_.empty())
+        {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+        }
+        else
+        {
+            slot = static_cast<std::uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+
+        Slot& s = slots_[slot];
+        s.value.emplace(std::move(value));
+        s.priority = std::move(priority);
+        s.heap_index = heap_.size();
+        heap_.push_back(slot);
+        sift_up(s.heap_index);
+
+        cond_var_.notify_one();
+        return Handle{ slot, s.generation };
+    }
+
+    // 修改元素优先级，句柄已失效（元素已出队或被删除）时返回false
+    bool update_priority(Handle handle, Priority priority)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!valid(handle))
+        {
+            return false;
+        }
+
+        Slot& s = slots_[handle.slot];
+        const bool raised = comp_(s.priority, priority);
+        s.priority = std::move(priority);
+        if (raised) sift_up(s.heap_index);
+        else sift_down(s.heap_index);
+        return true;
+    }
+
+    // 按句柄删除元素，句柄已失效时返回false
+    bool erase(Handle handle)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!valid(handle))
+        {
+            return false;
+        }
+
+        remove_at(slots_[handle.slot].heap_index);
+        return true;
+    }
+
+    // 句柄对应的元素是否仍在队列中
+    bool contains(Handle handle) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return valid(handle);
+    }
+
+    // 查询句柄对应元素的当前优先级
+    std::optional<Priority> priority(Handle handle) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!valid(handle))
+        {
+            return std::nullopt;
+        }
+        return slots_[handle.slot].priority;
+    }
+
+    // 出队操作（非阻塞式）：成功返回true并获取优先级最高的元素
+    bool try_pop(T& value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (heap_.empty())
+        {
+            return false;
+        }
+        value = take_top();
+        return true;
+    }
+
+    std::shared_ptr<T> try_pop()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (heap_.empty())
+        {
+            return nullptr;
+        }
+        return std::make_shared<T>(take_top());
+    }
+
+    // 出队操作（阻塞式）：队列为空时阻塞，直到有元素可用
+    void wait_and_pop(T& value)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_var_.wait(lock, [this] { return !heap_.empty(); });
+        value = take_top();
+    }
+
+    std::shared_ptr<T> wait_and_pop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_var_.wait(lock, [this] { return !heap_.empty(); });
+        return std::make_shared<T>(take_top());
+    }
+
+    bool empty() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return heap_.empty();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return heap_.size();
+    }
+
+private:
+    // 以下函数均需持有mutex_
+
+    bool valid(Handle handle) const
+    {
+        return handle.slot < slots_.size()
+            && slots_[handle.slot].generation == handle.generation
+            && slots_[handle.slot].value.has_value();
+    }
+
+    // 取出堆顶元素并释放其槽位
+    T take_top()
+    {
+        T value = std::move(*slots_[heap_.front()].value);
+        remove_at(0);
+        return value;
+    }
+
+    // 删除堆中位置为index的元素：用末尾元素填补，再根据优先级上浮或下沉
+    void remove_at(size_t index)
+    {
+        const std::uint32_t slot = heap_[index];
+        const size_t last = heap_.size() - 1;
+        if (index != last)
+        {
+            place(index, heap_[last]);
+        }
+        heap_.pop_back();
+
+        if (index < heap_.size())
+        {
+            if (index > 0 && comp_(slots_[heap_[(index - 1) / 2]].priority, slots_[heap_[index]].priority))
+            {
+                sift_up(index);
+            }
+            else
+            {
+                sift_down(index);
+            }
+        }
+
+        Slot& s = slots_[slot];
+        s.value.reset();
+        ++s.generation;
+        free_slots_.push_back(slot);
+    }
+
+    // 把槽位放到堆中位置index，并同步更新槽位记录的位置
+    void place(size_t index, std::uint32_t slot)
+    {
+        heap_[index] = slot;
+        slots_[slot].heap_index = index;
+    }
+
+    bool higher(std::uint32_t a, std::uint32_t b) const
+    {
+        return comp_(slots_[b].priority, slots_[a].priority);
+    }
+
+    void sift_up(size_t index)
+    {
+        const std::uint32_t slot = heap_[index];
+        while (index > 0)
+        {
+            const size_t parent = (index - 1) / 2;
+            if (!higher(slot, heap_[parent])) break;
+            place(index, heap_[parent]);
+            index = parent;
+        }
+        place(index, slot);
+    }
+
+    void sift_down(size_t index)
+    {
+        const std::uint32_t slot = heap_[index];
+        const size_t n = heap_.size();
+        while (true)
+        {
+            size_t child = 2 * index + 1;
+            if (child >= n) break;
+            if (child + 1 < n && higher(heap_[child + 1], heap_[child])) ++child;
+            if (!higher(heap_[child], slot)) break;
+            place(index, heap_[child]);
+            index = child;
+        }
+        place(index, slot);
+    }
+};
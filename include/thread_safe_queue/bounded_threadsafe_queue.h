@@ -1,9 +1,26 @@
+#pragma once
 #include"abstract_threadsafe_queue.h"
 #include<atomic>
+#include<deque>
+#include<vector>
+#include<optional>
+#include<utility>
+#include<stdexcept>
+#include<coro/task.h>
 
+/*
+有界队列：在任意无界队列外加容量限制。
+协程可以co_await async_pop()等待元素、co_await async_push(value)在队列满时等待空位（背压），
+等待期间只挂起协程而不占用线程：元素优先直接交给挂起的消费者，空位优先让给挂起的生产者，
+被唤醒的协程在各自指定的线程池上恢复。
+*/
 template<typename T, typename Queue>
 class BoundedThreadSafeQueue : public AbstractThreadSafeQueue<T>
 {
+public:
+    class PopAwaiter;
+    class PushAwaiter;
+
 private:
     Queue queue_;                  // 底层无界队列
     mutable std::mutex mutex_;     // 保护整个有界队列的锁
@@ -11,8 +28,127 @@ private:
     std::condition_variable not_full_cv_;   // 队列不满条件变量
     const size_t max_size_;        // 最大容量
     size_t current_size_ = 0;      // 当前队列大小(内置计数，避免调用底层size())
+    std::deque<PopAwaiter*> pop_waiters_;    // 挂起等待元素的协程（只在队列为空时非空）
+    std::deque<PushAwaiter*> push_waiters_;  // 挂起等待空位的协程（只在队列满时非空）
+
+    // 解锁后需要恢复的协程
+    using ResumeList = std::vector<std::pair<std::coroutine_handle<>, ThreadPool*>>;
 
 public:
+    // co_await async_pop()的等待体，位于挂起协程的帧中，恢复前一直有效
+    class PopAwaiter
+    {
+    private:
+        BoundedThreadSafeQueue& queue_;
+        ThreadPool* executor_;
+        std::optional<T> value_;
+        std::coroutine_handle<> handle_;
+        friend class BoundedThreadSafeQueue;
+
+    public:
+        PopAwaiter(BoundedThreadSafeQueue& queue, ThreadPool* executor) : queue_(queue), executor_(executor) {}
+
+        bool await_ready()
+        {
+            ResumeList resume;
+            bool ready = false;
+            {
+                std::lock_guard<std::mutex> lock(queue_.mutex_);
+                ready = take_locked(resume);
+            }
+            BoundedThreadSafeQueue::resume_all(resume);
+            return ready;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            ResumeList resume;
+            {
+                std::lock_guard<std::mutex> lock(queue_.mutex_);
+                if (!take_locked(resume))
+                {
+                    handle_ = handle;
+                    queue_.pop_waiters_.push_back(this);
+                    return true;
+                }
+            }
+            BoundedThreadSafeQueue::resume_all(resume);
+            return false;  // 判断与挂起之间有元素入队，不挂起
+        }
+
+        T await_resume() { return std::move(*value_); }
+
+    private:
+        bool take_locked(ResumeList& resume)
+        {
+            if (queue_.current_size_ == 0)
+            {
+                return false;
+            }
+            auto item = queue_.queue_.try_pop();
+            value_.emplace(std::move(*item));
+            queue_.current_size_--;
+            queue_.release_slot_locked(resume);
+            return true;
+        }
+    };
+
+    // co_await async_push(value)的等待体：队列满时保存元素并挂起，有空位时由出队方放入并恢复协程
+    class PushAwaiter
+    {
+    private:
+        BoundedThreadSafeQueue& queue_;
+        ThreadPool* executor_;
+        std::optional<T> value_;
+        std::coroutine_handle<> handle_;
+        friend class BoundedThreadSafeQueue;
+
+    public:
+        PushAwaiter(BoundedThreadSafeQueue& queue, T value, ThreadPool* executor)
+            : queue_(queue), executor_(executor), value_(std::move(value)) {}
+
+        bool await_ready()
+        {
+            ResumeList resume;
+            bool ready = false;
+            {
+                std::lock_guard<std::mutex> lock(queue_.mutex_);
+                ready = put_locked(resume);
+            }
+            BoundedThreadSafeQueue::resume_all(resume);
+            return ready;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            ResumeList resume;
+            {
+                std::lock_guard<std::mutex> lock(queue_.mutex_);
+                if (!put_locked(resume))
+                {
+                    handle_ = handle;
+                    queue_.push_waiters_.push_back(this);
+                    return true;
+                }
+            }
+            BoundedThreadSafeQueue::resume_all(resume);
+            return false;
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        bool put_locked(ResumeList& resume)
+        {
+            if (queue_.current_size_ >= queue_.max_size_)
+            {
+                return false;
+            }
+            queue_.deliver_locked(std::move(*value_), resume);
+            return true;
+        }
+    };
+
     explicit BoundedThreadSafeQueue(size_t max_size)
         : max_size_(max_size)
     {
@@ -25,95 +161,130 @@ public:
     // 阻塞式入队
     void push(T value) override
     {
-        std::unique_lock<std::mutex> lock(mutex_);
-        // 使用内置current_size_判断，避免调用底层size()
-        not_full_cv_.wait(lock, [this]() {
-            return current_size_ < max_size_;
-            });
+        ResumeList resume;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // 使用内置current_size_判断，避免调用底层size()
+            not_full_cv_.wait(lock, [this]() {
+                return current_size_ < max_size_;
+                });
 
-        // 先入队，成功后再更新计数(保证异常安全)
-        queue_.push(std::move(value));
-        current_size_++;  // 同步更新当前大小
-        not_empty_cv_.notify_one();  // 通知消费者有数据
+            // 先入队，成功后再更新计数(保证异常安全)；有挂起的消费者时直接交给它
+            deliver_locked(std::move(value), resume);
+        }
+        resume_all(resume);
     }
 
     // 非阻塞式入队
-    bool try_push(T value) 
+    bool try_push(T value)
     {
-        std::unique_lock<std::mutex> lock(mutex_);
-        if (current_size_ >= max_size_)
+        ResumeList resume;
         {
-            return false;  // 队列已满
-        }
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (current_size_ >= max_size_)
+            {
+                return false;  // 队列已满
+            }
 
-        queue_.push(std::move(value));
-        current_size_++;
-        not_empty_cv_.notify_one();
+            deliver_locked(std::move(value), resume);
+        }
+        resume_all(resume);
         return true;
     }
 
+    // 协程中等待并取出元素：co_await queue.async_pop()
+    PopAwaiter async_pop(ThreadPool& executor = default_thread_pool())
+    {
+        return PopAwaiter(*this, &executor);
+    }
+
+    // 协程中入队，队列满时挂起直到有空位：co_await queue.async_push(value)
+    PushAwaiter async_push(T value, ThreadPool& executor = default_thread_pool())
+    {
+        return PushAwaiter(*this, std::move(value), &executor);
+    }
+
     // 非阻塞式出队(返回智能指针)
     std::shared_ptr<T> try_pop() override
     {
-        std::unique_lock<std::mutex> lock(mutex_);
-        if (current_size_ == 0)
+        ResumeList resume;
+        std::shared_ptr<T> result;
         {
-            return nullptr;  // 队列为空
-        }
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (current_size_ == 0)
+            {
+                return nullptr;  // 队列为空
+            }
 
-        auto result = queue_.try_pop();
-        if (result)
-        {  // 确保出队成功
-            current_size_--;
-            not_full_cv_.notify_one();  // 通知生产者有空间
+            result = queue_.try_pop();
+            if (result)
+            {  // 确保出队成功
+                current_size_--;
+                release_slot_locked(resume);  // 通知生产者有空间
+            }
         }
+        resume_all(resume);
         return result;
     }
 
     // 阻塞式出队(返回智能指针)
     std::shared_ptr<T> wait_and_pop() override
     {
-        std::unique_lock<std::mutex> lock(mutex_);
-        // 使用内置current_size_判断，避免调用底层empty()
-        not_empty_cv_.wait(lock, [this]() {
-            return current_size_ > 0;
-            });
+        ResumeList resume;
+        std::shared_ptr<T> result;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // 使用内置current_size_判断，避免调用底层empty()
+            not_empty_cv_.wait(lock, [this]() {
+                return current_size_ > 0;
+                });
 
-        auto result = queue_.wait_and_pop();
-        current_size_--;
-        not_full_cv_.notify_one();
+            result = queue_.wait_and_pop();
+            current_size_--;
+            release_slot_locked(resume);
+        }
+        resume_all(resume);
         return result;
     }
 
     // 非阻塞式出队(通过引用返回)
     bool try_pop(T& value) override
     {
-        std::unique_lock<std::mutex> lock(mutex_);
-        if (current_size_ == 0)
+        ResumeList resume;
+        bool success = false;
         {
-            return false;
-        }
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (current_size_ == 0)
+            {
+                return false;
+            }
 
-        bool success = queue_.try_pop(value);
-        if (success)
-        {
-            current_size_--;
-            not_full_cv_.notify_one();
+            success = queue_.try_pop(value);
+            if (success)
+            {
+                current_size_--;
+                release_slot_locked(resume);
+            }
         }
+        resume_all(resume);
         return success;
     }
 
     // 阻塞式出队(通过引用返回)
     void wait_and_pop(T& value) override
     {
-        std::unique_lock<std::mutex> lock(mutex_);
-        not_empty_cv_.wait(lock, [this]() {
-            return current_size_ > 0;
-            });
+        ResumeList resume;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_empty_cv_.wait(lock, [this]() {
+                return current_size_ > 0;
+                });
 
-        queue_.wait_and_pop(value);
-        current_size_--;
-        not_full_cv_.notify_one();
+            queue_.wait_and_pop(value);
+            current_size_--;
+            release_slot_locked(resume);
+        }
+        resume_all(resume);
     }
 
     // 直接返回内置计数，O(1)复杂度
@@ -129,4 +300,44 @@ public:
         std::lock_guard<std::mutex> lock(mutex_);
         return current_size_ == 0;
     }
+
+private:
+    // 放入一个元素（调用者已确认有空位）：有挂起的消费者时直接交给等待最久的一个，否则入队
+    void deliver_locked(T&& value, ResumeList& resume)
+    {
+        if (!pop_waiters_.empty())
+        {
+            PopAwaiter* waiter = pop_waiters_.front();
+            pop_waiters_.pop_front();
+            waiter->value_.emplace(std::move(value));
+            resume.emplace_back(waiter->handle_, waiter->executor_);
+            return;
+        }
+        queue_.push(std::move(value));
+        current_size_++;  // 同步更新当前大小
+        not_empty_cv_.notify_one();  // 通知消费者有数据
+    }
+
+    // 出队后空出一个位置：有挂起的生产者时把它的元素放入并恢复它，否则通知阻塞的生产者
+    void release_slot_locked(ResumeList& resume)
+    {
+        if (!push_waiters_.empty())
+        {
+            PushAwaiter* waiter = push_waiters_.front();
+            push_waiters_.pop_front();
+            deliver_locked(std::move(*waiter->value_), resume);
+            resume.emplace_back(waiter->handle_, waiter->executor_);
+            return;
+        }
+        not_full_cv_.notify_one();
+    }
+
+    // 解锁后再恢复，协程可能立即再次访问本队列
+    static void resume_all(ResumeList& resume)
+    {
+        for (auto& [handle, executor] : resume)
+        {
+            resume_on(executor, handle);
+        }
+    }
 };
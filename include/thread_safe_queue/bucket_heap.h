@@ -0,0 +1,324 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <bit>
+#include <limits>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+/*
+整数优先级的堆引擎，适用于优先级是小整数或单调递增时间戳的场景，此时比较堆的O(log n)开销没有必要。
+- BucketHeap：键取值范围固定为[0, Buckets)，每个键一个桶，入队O(1)；
+  出队时用非空桶位图查找下一个非空桶，优先级单调变化时均摊O(1)。
+- RadixHeap：键为任意无符号整数，但要求单调（入队的键不小于最近一次出队的键），按与当前最小键的最高不同位分桶，
+  入队O(1)，出队时只重新分配一个桶，每个元素最多被移动键位宽次，均摊O(log C)（C为键的取值跨度）。
+与DaryHeap一样，通过作为Container模板参数传给ThreadSafePriorityQueue、DelayQueue或HierarchicalPriorityQueue接入。
+所有成员函数都不加锁，由外层的线程安全队列负责同步。
+*/
+
+// 默认键提取：元素本身就是整数优先级
+struct IntegralKey
+{
+    template <typename T>
+    constexpr std::uint64_t operator()(const T& value) const noexcept
+    {
+        return static_cast<std::uint64_t>(value);
+    }
+};
+
+// Compare只用于确定方向：std::greater表示键小者优先，其余（默认std::less）表示键大者优先，
+// 与std::priority_queue的约定一致
+template <typename Compare>
+struct is_min_first : std::false_type {};
+
+template <typename U>
+struct is_min_first<std::greater<U>> : std::true_type {};
+
+template <typename T, typename Container, typename Compare>
+class BucketHeap;
+
+template <typename T, typename Container, typename Compare>
+class RadixHeap;
+
+// 桶式堆的底层容器：每个键一个桶
+template <typename T, std::size_t Buckets = 256, typename KeyOf = IntegralKey>
+class BucketHeapContainer : public std::vector<std::vector<T>>
+{
+    static_assert(Buckets > 0, "BucketHeap needs at least one bucket");
+
+public:
+    using value_type = T;
+    using key_of = KeyOf;
+    static constexpr std::size_t bucket_count = Buckets;
+
+    template <typename U, typename C, typename Compare>
+    using heap_engine = BucketHeap<U, C, Compare>;
+
+    BucketHeapContainer() : std::vector<std::vector<T>>(Buckets) {}
+};
+
+// 基数堆的底层容器：64位键，共65个桶（桶0存放等于当前最小键的元素）
+template <typename T, typename KeyOf = IntegralKey>
+class RadixHeapContainer : public std::array<std::vector<T>, 65>
+{
+public:
+    using value_type = T;
+    using key_of = KeyOf;
+
+    template <typename U, typename C, typename Compare>
+    using heap_engine = RadixHeap<U, C, Compare>;
+};
+
+template <typename T, typename Container, typename Compare>
+class BucketHeap
+{
+public:
+    using container_type = Container;
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_reference = const T&;
+
+private:
+    static constexpr std::size_t kBuckets = Container::bucket_count;
+    static constexpr std::size_t kWords = (kBuckets + 63) / 64;
+    static constexpr bool kMinFirst = is_min_first<Compare>::value;
+
+    Container buckets_;
+    std::array<std::uint64_t, kWords> non_empty_{};  // 非空桶位图
+    std::size_t size_ = 0;
+    std::size_t cursor_ = 0;  // 当前优先级最高的非空桶（size_>0时有效）
+    typename Container::key_of key_of_;
+
+public:
+    BucketHeap() = default;
+    explicit BucketHeap(const Compare&) {}
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    const_reference top() const { return buckets_[cursor_].back(); }
+
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        T value(std::forward<Args>(args)...);
+        const std::uint64_t key = key_of_(value);
+        if (key >= kBuckets)
+        {
+            throw std::out_of_range("BucketHeap key exceeds bucket range");
+        }
+
+        const std::size_t bucket = static_cast<std::size_t>(key);
+        buckets_[bucket].push_back(std::move(value));
+        non_empty_[bucket / 64] |= std::uint64_t(1) << (bucket % 64);
+        if (size_ == 0 || better(bucket, cursor_))
+        {
+            cursor_ = bucket;
+        }
+        ++size_;
+    }
+
+    void pop()
+    {
+        auto& bucket = buckets_[cursor_];
+        bucket.pop_back();
+        --size_;
+        if (bucket.empty())
+        {
+            non_empty_[cursor_ / 64] &= ~(std::uint64_t(1) << (cursor_ % 64));
+            if (size_ > 0)
+            {
+                cursor_ = next_non_empty(cursor_);
+            }
+        }
+    }
+
+    template <typename InputIt>
+    void push_range(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            push(*first);
+        }
+    }
+
+    template <typename OutputIt>
+    std::size_t pop_top_k(OutputIt out, std::size_t k)
+    {
+        std::size_t popped = 0;
+        while (popped < k && size_ > 0)
+        {
+            *out++ = std::move(buckets_[cursor_].back());
+            pop();
+            ++popped;
+        }
+        return popped;
+    }
+
+    // 移出堆顶元素（移动而非拷贝），支持只能移动的元素类型
+    T extract_top()
+    {
+        T value = std::move(buckets_[cursor_].back());
+        pop();
+        return value;
+    }
+
+private:
+    static bool better(std::size_t a, std::size_t b)
+    {
+        return kMinFirst ? a < b : a > b;
+    }
+
+    // 从from开始沿优先级降低的方向查找下一个非空桶（调用前保证存在）
+    std::size_t next_non_empty(std::size_t from) const
+    {
+        if constexpr (kMinFirst)
+        {
+            std::size_t word = from / 64;
+            std::uint64_t bits = non_empty_[word] & (~std::uint64_t(0) << (from % 64));
+            while (bits == 0)
+            {
+                bits = non_empty_[++word];
+            }
+            return word * 64 + std::countr_zero(bits);
+        }
+        else
+        {
+            std::size_t word = from / 64;
+            const unsigned shift = 63 - static_cast<unsigned>(from % 64);
+            std::uint64_t bits = non_empty_[word] & (~std::uint64_t(0) >> shift);
+            while (bits == 0)
+            {
+                bits = non_empty_[--word];
+            }
+            return word * 64 + 63 - std::countl_zero(bits);
+        }
+    }
+};
+
+template <typename T, typename Container, typename Compare>
+class RadixHeap
+{
+    static_assert(is_min_first<Compare>::value,
+        "RadixHeap only supports min-first order; use std::greater as Compare");
+
+public:
+    using container_type = Container;
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_reference = const T&;
+
+private:
+    // 桶数据在top()中可能被重新分配（不改变逻辑内容），因此声明为mutable
+    mutable Container buckets_;
+    mutable std::uint64_t last_ = 0;  // 当前分桶基准：最近一次top()/pop()看到的最小键
+    std::size_t size_ = 0;
+    typename Container::key_of key_of_;
+
+public:
+    RadixHeap() = default;
+    explicit RadixHeap(const Compare&) {}
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    const_reference top() const
+    {
+        refill();
+        return buckets_[0].back();
+    }
+
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    // 入队的键必须不小于最近一次top()/pop()看到的键，否则抛出std::invalid_argument
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        T value(std::forward<Args>(args)...);
+        const std::uint64_t key = key_of_(value);
+        if (key < last_)
+        {
+            throw std::invalid_argument("RadixHeap requires monotone keys");
+        }
+        buckets_[bucket_of(key)].push_back(std::move(value));
+        ++size_;
+    }
+
+    void pop()
+    {
+        refill();
+        buckets_[0].pop_back();
+        --size_;
+    }
+
+    template <typename InputIt>
+    void push_range(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            push(*first);
+        }
+    }
+
+    template <typename OutputIt>
+    std::size_t pop_top_k(OutputIt out, std::size_t k)
+    {
+        std::size_t popped = 0;
+        while (popped < k && size_ > 0)
+        {
+            refill();
+            *out++ = std::move(buckets_[0].back());
+            buckets_[0].pop_back();
+            --size_;
+            ++popped;
+        }
+        return popped;
+    }
+
+    // 移出堆顶元素（移动而非拷贝），支持只能移动的元素类型
+    T extract_top()
+    {
+        refill();
+        T value = std::move(buckets_[0].back());
+        buckets_[0].pop_back();
+        --size_;
+        return value;
+    }
+
+private:
+    std::size_t bucket_of(std::uint64_t key) const
+    {
+        return static_cast<std::size_t>(std::bit_width(key ^ last_));
+    }
+
+    // 桶0为空时，找到第一个非空桶，以其中的最小键为新基准重新分桶；
+    // 该桶内的元素与新基准的最高不同位一定更低，因此全部落入更小的桶
+    void refill() const
+    {
+        if (!buckets_[0].empty()) return;
+
+        std::size_t i = 1;
+        while (buckets_[i].empty()) ++i;
+
+        auto& source = buckets_[i];
+        std::uint64_t new_last = std::numeric_limits<std::uint64_t>::max();
+        for (const auto& value : source)
+        {
+            const std::uint64_t key = key_of_(value);
+            if (key < new_last) new_last = key;
+        }
+        last_ = new_last;
+
+        for (auto& value : source)
+        {
+            buckets_[bucket_of(key_of_(value))].push_back(std::move(value));
+        }
+        source.clear();
+    }
+};
@@ -0,0 +1,298 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*
+缓存友好的d叉堆。
+元素数量达到百万级时，二叉堆的下沉操作每层都会访问一条新的缓存行，主要开销来自缓存未命中。
+d叉堆把树高降低到log_d(n)，并让同一父节点的d个子节点在内存中连续：
+只要 d*sizeof(T) 能整除缓存行大小，并且底层存储按下面的方式对齐，每组兄弟节点恰好落在一条缓存行内，
+下沉时每层只有一次缓存未命中。
+*/
+
+inline constexpr std::size_t kCacheLineSize = 64;
+
+// 堆专用的对齐分配器：保证下标1（根的第一个子节点）位于缓存行起点，
+// 此后下标为 d*i+1 的每组兄弟节点都从缓存行起点开始
+template <typename T, std::size_t Align = kCacheLineSize>
+struct HeapAlignedAllocator
+{
+    using value_type = T;
+
+    // 实际对齐取 Align 与 alignof(T) 中较大者：下标0位于 aligned - sizeof(T)，
+    // 只有对齐值不小于 alignof(T) 时它才满足 T 自身的对齐要求（sizeof(T) 总是 alignof(T) 的倍数）
+    static constexpr std::size_t alignment = Align > alignof(T) ? Align : alignof(T);
+
+    template <typename U>
+    struct rebind
+    {
+        using other = HeapAlignedAllocator<U, Align>;
+    };
+
+    HeapAlignedAllocator() noexcept = default;
+
+    template <typename U>
+    HeapAlignedAllocator(const HeapAlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(std::size_t n)
+    {
+        // 额外申请 alignment 字节用于对齐，再预留一个指针大小的位置保存原始地址
+        const std::size_t bytes = n * sizeof(T) + alignment + sizeof(void*);
+        char* raw = static_cast<char*>(::operator new(bytes));
+
+        std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw + sizeof(void*)) + sizeof(T);
+        addr = (addr + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        char* aligned = reinterpret_cast<char*>(addr - sizeof(T));
+
+        std::memcpy(aligned - sizeof(void*), &raw, sizeof(void*));
+        return reinterpret_cast<T*>(aligned);
+    }
+
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        char* raw = nullptr;
+        std::memcpy(&raw, reinterpret_cast<char*>(p) - sizeof(void*), sizeof(void*));
+        ::operator delete(raw);
+    }
+
+    template <typename U>
+    bool operator==(const HeapAlignedAllocator<U, Align>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const HeapAlignedAllocator<U, Align>&) const noexcept { return false; }
+};
+
+template <typename T, typename Container, typename Compare>
+class DaryHeap;
+
+// d叉堆的底层容器：作为ThreadSafePriorityQueue、DelayQueue和HierarchicalPriorityQueue的Container模板参数传入时，
+// 这些队列会自动改用DaryHeap作为堆引擎。常用的Arity为4或8。
+template <typename T, std::size_t Arity = 4>
+class DaryHeapContainer : public std::vector<T, HeapAlignedAllocator<T>>
+{
+    static_assert(Arity >= 2, "Heap arity must be at least 2");
+
+public:
+    static constexpr std::size_t heap_arity = Arity;
+
+    template <typename U, typename C, typename Compare>
+    using heap_engine = DaryHeap<U, C, Compare>;
+
+    using std::vector<T, HeapAlignedAllocator<T>>::vector;
+};
+
+// d叉堆引擎：接口与std::priority_queue以及BinaryHeap保持一致（push/pop/top/批量操作）
+// 所有成员函数都不加锁，由外层的线程安全队列负责同步。
+template <typename T, typename Container, typename Compare>
+class DaryHeap
+{
+public:
+    using container_type = Container;
+    using value_compare = Compare;
+    using value_type = typename Container::value_type;
+    using size_type = typename Container::size_type;
+    using reference = typename Container::reference;
+    using const_reference = typename Container::const_reference;
+
+    static constexpr std::size_t arity = Container::heap_arity;
+
+private:
+    Container c_;
+    Compare comp_;
+
+public:
+    DaryHeap() = default;
+    explicit DaryHeap(const Compare& comp) : comp_(comp) {}
+
+    bool empty() const noexcept { return c_.empty(); }
+    size_type size() const noexcept { return c_.size(); }
+    const_reference top() const { return c_.front(); }
+
+    void push(const value_type& value)
+    {
+        c_.push_back(value);
+        sift_up(c_.size() - 1);
+    }
+
+    void push(value_type&& value)
+    {
+        c_.push_back(std::move(value));
+        sift_up(c_.size() - 1);
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        c_.emplace_back(std::forward<Args>(args)...);
+        sift_up(c_.size() - 1);
+    }
+
+    // 出队采用自底向上策略：先沿最优子节点把堆顶空洞移到叶子，再把末尾元素从该处上浮。
+    // 末尾元素通常很小，上浮步数极少，每层省去一次与末尾元素的比较。
+    void pop()
+    {
+        const std::size_t n = c_.size() - 1;
+        if (n == 0)
+        {
+            c_.pop_back();
+            return;
+        }
+
+        std::size_t hole = 0;
+        while (true)
+        {
+            const std::size_t first_child = hole * arity + 1;
+            if (first_child >= n) break;
+
+            const std::size_t best = best_child(first_child, n);
+            c_[hole] = std::move(c_[best]);
+            hole = best;
+        }
+
+        if (hole != n)
+        {
+            c_[hole] = std::move(c_[n]);
+            c_.pop_back();
+            sift_up(hole);
+        }
+        else
+        {
+            c_.pop_back();
+        }
+    }
+
+    // 批量入队：与BinaryHeap相同的策略，批量相对堆较大时整体堆化
+    template <typename InputIt>
+    void push_range(InputIt first, InputIt last)
+    {
+        const std::size_t old_size = c_.size();
+        c_.insert(c_.end(), first, last);
+        const std::size_t batch = c_.size() - old_size;
+        if (batch == 0) return;
+
+        if (should_heapify(old_size, batch))
+        {
+            make_heap();
+        }
+        else
+        {
+            for (std::size_t i = old_size; i < c_.size(); ++i)
+            {
+                sift_up(i);
+            }
+        }
+    }
+
+    // 批量出队：依次取出最多k个优先级最高的元素写入out，返回实际取出的数量
+    template <typename OutputIt>
+    std::size_t pop_top_k(OutputIt out, std::size_t k)
+    {
+        std::size_t popped = 0;
+        while (popped < k && !c_.empty())
+        {
+            *out++ = std::move(c_.front());
+            pop();
+            ++popped;
+        }
+        return popped;
+    }
+
+    // 移出堆顶元素（移动而非拷贝），支持只能移动的元素类型
+    value_type extract_top()
+    {
+        value_type value = std::move(c_.front());
+        pop();
+        return value;
+    }
+
+    void swap(DaryHeap& other) noexcept
+    {
+        using std::swap;
+        swap(c_, other.c_);
+        swap(comp_, other.comp_);
+    }
+
+    Container& container() noexcept { return c_; }
+    const Container& container() const noexcept { return c_; }
+
+private:
+    // 在从first_child开始的一组兄弟节点中选出优先级最高者。
+    // 完整的兄弟组使用固定次数的循环，便于编译器展开并生成条件传送而非分支
+    std::size_t best_child(std::size_t first_child, std::size_t n) const
+    {
+        std::size_t best = first_child;
+        if (first_child + arity <= n)
+        {
+            for (std::size_t i = 1; i < arity; ++i)
+            {
+                const std::size_t child = first_child + i;
+                best = comp_(c_[best], c_[child]) ? child : best;
+            }
+        }
+        else
+        {
+            for (std::size_t child = first_child + 1; child < n; ++child)
+            {
+                best = comp_(c_[best], c_[child]) ? child : best;
+            }
+        }
+        return best;
+    }
+
+    // 上浮：沿父节点链移动“空洞”，最后一次性写入，避免反复交换
+    void sift_up(std::size_t hole)
+    {
+        value_type value = std::move(c_[hole]);
+        while (hole > 0)
+        {
+            const std::size_t parent = (hole - 1) / arity;
+            if (!comp_(c_[parent], value)) break;
+            c_[hole] = std::move(c_[parent]);
+            hole = parent;
+        }
+        c_[hole] = std::move(value);
+    }
+
+    // 下沉：每层在连续的d个子节点中选出优先级最高者
+    void sift_down(std::size_t hole, value_type value)
+    {
+        const std::size_t n = c_.size();
+        while (true)
+        {
+            const std::size_t first_child = hole * arity + 1;
+            if (first_child >= n) break;
+
+            const std::size_t best = best_child(first_child, n);
+            if (!comp_(value, c_[best])) break;
+            c_[hole] = std::move(c_[best]);
+            hole = best;
+        }
+        c_[hole] = std::move(value);
+    }
+
+    // 自底向上堆化，O(n)
+    void make_heap()
+    {
+        const std::size_t n = c_.size();
+        if (n < 2) return;
+        for (std::size_t i = (n - 2) / arity + 1; i-- > 0;)
+        {
+            value_type value = std::move(c_[i]);
+            sift_down(i, std::move(value));
+        }
+    }
+
+    static bool should_heapify(std::size_t old_size, std::size_t batch)
+    {
+        const std::size_t total = old_size + batch;
+        std::size_t log_total = 0;
+        for (std::size_t t = total; t > 1; t /= arity) ++log_total;
+        return batch * log_total > total;
+    }
+};
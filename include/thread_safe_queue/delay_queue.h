@@ -6,6 +6,15 @@
 #include <optional>
 #include <algorithm>
 #include <memory>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <coro/task.h>
+#include "priority_heap.h"
+
+class CoroutineTimer;
+inline CoroutineTimer& default_timer();
 
 // 延迟队列中的元素包装类：包含实际数据和到期时间
 template <typename T>
@@ -23,37 +32,120 @@ struct DelayElement
 };
 
 // 延迟队列类
-template <typename T>
+// Container决定堆引擎：默认二叉堆，传入DaryHeapContainer<DelayElement<T>, 4>等使用d叉堆
+// 协程通过co_await queue.async_pop()等待元素到期：挂起期间不占用线程，由default_timer()在最早到期时刻唤醒检查，
+// 到期元素直接交给等待最久的协程并在其指定的线程池上恢复
+template <typename T, typename Container = std::vector<DelayElement<T>>>
 class DelayQueue
 {
+public:
+    class PopAwaiter;
+
 private:
     using Clock = std::chrono::steady_clock;
     using TimePoint = Clock::time_point;
     using Duration = Clock::duration;
+    using ResumeList = std::vector<std::pair<std::coroutine_handle<>, ThreadPool*>>;
 
-    std::priority_queue<DelayElement<T>> queue_;  // 优先队列（按到期时间排序）
+    // 计时器回调通过它访问队列：队列析构时置空，已预约的回调随之失效
+    struct AsyncLink
+    {
+        explicit AsyncLink(DelayQueue* owner) : queue(owner) {}
+        std::mutex mutex;
+        DelayQueue* queue;
+    };
+
+    heap_engine_t<DelayElement<T>, Container, std::less<DelayElement<T>>> queue_;  // 优先队列（按到期时间排序）
     mutable std::mutex mtx_;                     // 保护队列的互斥锁
     std::condition_variable cv_;                 // 条件变量，用于等待元素到期
+    std::deque<PopAwaiter*> pop_waiters_;        // 挂起等待到期元素的协程
+    std::optional<TimePoint> armed_;             // 已向计时器预约的最早唤醒时刻
+    std::shared_ptr<AsyncLink> link_ = std::make_shared<AsyncLink>(this);
 
 public:
+    // co_await async_pop()的等待体，位于挂起协程的帧中，恢复前一直有效
+    class PopAwaiter
+    {
+    private:
+        DelayQueue& queue_;
+        ThreadPool* executor_;
+        std::optional<T> value_;
+        std::coroutine_handle<> handle_;
+        friend class DelayQueue;
+
+    public:
+        PopAwaiter(DelayQueue& queue, ThreadPool* executor) : queue_(queue), executor_(executor) {}
+
+        bool await_ready()
+        {
+            std::lock_guard<std::mutex> lock(queue_.mtx_);
+            return take_locked();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            std::lock_guard<std::mutex> lock(queue_.mtx_);
+            if (take_locked())
+            {
+                return false;
+            }
+            handle_ = handle;
+            queue_.pop_waiters_.push_back(this);
+            queue_.arm_locked();
+            return true;
+        }
+
+        T await_resume() { return std::move(*value_); }
+
+    private:
+        bool take_locked()
+        {
+            if (queue_.queue_.empty() || Clock::now() < queue_.queue_.top().expire_time)
+            {
+                return false;
+            }
+            value_.emplace(std::move(const_cast<DelayElement<T>&>(queue_.queue_.top()).data));
+            queue_.queue_.pop();
+            return true;
+        }
+    };
+
+    DelayQueue() = default;
+    DelayQueue(const DelayQueue&) = delete;
+    DelayQueue& operator=(const DelayQueue&) = delete;
+
+    ~DelayQueue()
+    {
+        std::lock_guard<std::mutex> lock(link_->mutex);
+        link_->queue = nullptr;
+    }
+
     // 入队：添加元素，指定延迟时间（相对时间，如5秒后到期）
     void push(const T& data, Duration delay)
     {
-        std::lock_guard<std::mutex> lock(mtx_);
-        // 计算绝对到期时间（当前时间 + 延迟时间）
-        TimePoint expire_time = Clock::now() + delay;
-        queue_.push({ data, expire_time });
-        // 唤醒可能等待的消费者（若新元素是最早到期的，需重新计算等待时间）
-        cv_.notify_one();
+        push(T(data), delay);
     }
 
     // 入队：支持移动语义
     void push(T&& data, Duration delay)
     {
-        std::lock_guard<std::mutex> lock(mtx_);
-        TimePoint expire_time = Clock::now() + delay;
-        queue_.push({ std::move(data), expire_time });
-        cv_.notify_one();
+        ResumeList resume;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            // 计算绝对到期时间（当前时间 + 延迟时间）
+            TimePoint expire_time = Clock::now() + delay;
+            queue_.push({ std::move(data), expire_time });
+            // 唤醒可能等待的消费者（若新元素是最早到期的，需重新计算等待时间）
+            cv_.notify_one();
+            dispatch_locked(resume);
+        }
+        resume_all(resume);
+    }
+
+    // 协程中等待并取出到期元素：co_await queue.async_pop()；在executor上恢复协程
+    PopAwaiter async_pop(ThreadPool& executor = default_thread_pool())
+    {
+        return PopAwaiter(*this, &executor);
     }
 
     // 出队：阻塞等待，直到有元素到期并返回（返回值包含数据）
@@ -142,4 +234,152 @@ public:
         std::lock_guard<std::mutex> lock(mtx_);
         return queue_.size();
     }
+
+private:
+    // 把到期元素依次交给挂起的协程；仍有协程等待时向计时器预约下一次检查
+    void dispatch_locked(ResumeList& resume)
+    {
+        if (pop_waiters_.empty())
+        {
+            return;
+        }
+        const TimePoint now = Clock::now();
+        while (!pop_waiters_.empty() && !queue_.empty() && now >= queue_.top().expire_time)
+        {
+            PopAwaiter* waiter = pop_waiters_.front();
+            pop_waiters_.pop_front();
+            waiter->value_.emplace(std::move(const_cast<DelayElement<T>&>(queue_.top()).data));
+            queue_.pop();
+            resume.emplace_back(waiter->handle_, waiter->executor_);
+        }
+        arm_locked();
+    }
+
+    // 在堆顶元素到期时刻唤醒检查（已预约更早的时刻时不重复预约）
+    void arm_locked();
+
+    // 计时器回调：队列仍存在时分发到期元素，解锁后恢复协程
+    static void on_timer(const std::shared_ptr<AsyncLink>& link)
+    {
+        ResumeList resume;
+        {
+            std::lock_guard<std::mutex> link_lock(link->mutex);
+            if (link->queue == nullptr)
+            {
+                return;
+            }
+            DelayQueue& self = *link->queue;
+            std::lock_guard<std::mutex> lock(self.mtx_);
+            if (self.armed_ && *self.armed_ <= Clock::now())
+            {
+                self.armed_.reset();
+            }
+            self.dispatch_locked(resume);
+        }
+        resume_all(resume);
+    }
+
+    // 解锁后再恢复，协程可能立即再次访问本队列
+    static void resume_all(ResumeList& resume)
+    {
+        for (auto& [handle, executor] : resume)
+        {
+            resume_on(executor, handle);
+        }
+    }
+};
+
+// 协程计时器：一个后台线程从DelayQueue中依次取出到期的回调并执行，
+// co_await sleep_for(...)挂起的协程到期后在指定的线程池上恢复。析构时未到期的回调被丢弃
+class CoroutineTimer
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    DelayQueue<std::function<void()>> callbacks_;
+    std::thread thread_;
+
+public:
+    CoroutineTimer() : thread_([this] { run(); }) {}
+
+    CoroutineTimer(const CoroutineTimer&) = delete;
+    CoroutineTimer& operator=(const CoroutineTimer&) = delete;
+
+    ~CoroutineTimer()
+    {
+        callbacks_.push(std::function<void()>(), Clock::duration::zero());  // 空回调作为停止信号
+        thread_.join();
+    }
+
+    void schedule_after(Clock::duration delay, std::function<void()> callback)
+    {
+        callbacks_.push(std::move(callback), delay);
+    }
+
+    void schedule_at(Clock::time_point when, std::function<void()> callback)
+    {
+        schedule_after(when - Clock::now(), std::move(callback));
+    }
+
+private:
+    void run()
+    {
+        while (true)
+        {
+            std::function<void()> callback = callbacks_.pop();
+            if (!callback)
+            {
+                return;
+            }
+            callback();
+        }
+    }
 };
+
+// 进程级共享计时器；线程池先于计时器构造、后于其析构，计时器线程停止前回调可以安全地投递到线程池
+inline CoroutineTimer& default_timer()
+{
+    default_thread_pool();
+    static CoroutineTimer timer;
+    return timer;
+}
+
+template <typename T, typename Container>
+void DelayQueue<T, Container>::arm_locked()
+{
+    if (pop_waiters_.empty() || queue_.empty())
+    {
+        return;
+    }
+    const TimePoint when = queue_.top().expire_time;
+    if (armed_ && *armed_ <= when)
+    {
+        return;
+    }
+    armed_ = when;
+    default_timer().schedule_at(when, [link = link_] { on_timer(link); });
+}
+
+// co_await sleep_for(delay)：挂起当前协程，到期后在executor上恢复，不占用线程
+template <typename Rep, typename Period>
+auto sleep_for(std::chrono::duration<Rep, Period> delay,
+    ThreadPool& executor = default_thread_pool(), CoroutineTimer& timer = default_timer())
+{
+    struct awaiter
+    {
+        std::chrono::steady_clock::duration delay;
+        ThreadPool* executor;
+        CoroutineTimer* timer;
+
+        bool await_ready() const noexcept { return delay <= std::chrono::steady_clock::duration::zero(); }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            ThreadPool* target = executor;
+            timer->schedule_after(delay, [handle, target] { resume_on(target, handle); });
+        }
+
+        void await_resume() const noexcept {}
+    };
+    return awaiter{ std::chrono::ceil<std::chrono::steady_clock::duration>(delay), &executor, &timer };
+}
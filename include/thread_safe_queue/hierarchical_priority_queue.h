@@ -10,42 +10,181 @@
 #include <memory>
 #include <chrono>
 #include <unordered_map>
+#include <cstdint>
+#include <bit>
+#include <random>
+#include <type_traits>
 #include<shared_mutex>
+#include"priority_heap.h"
+
+// 窃取时的目标选择策略
+enum class StealPolicy
+{
+    first_found,  // 扫描位图，从第一个非空的局部队列窃取
+    best_of_two,  // 随机选两个非空的局部队列，从队首优先级更高的一个窃取
+    best          // 比较所有非空局部队列的队首，从优先级最高的一个窃取
+};
+
+struct HierarchicalQueueOptions
+{
+    std::size_t local_threshold = 100;                  // 局部队列触发合并的阈值
+    std::size_t max_steal = 10;                         // 批量窃取的最大数量
+    std::chrono::milliseconds wait_timeout{ 100 };      // 等待超时时间
+    std::size_t max_local_queues = 0;                   // 拥有局部队列的线程数上限，0表示硬件线程数的2倍（至少64）
+    StealPolicy steal_policy = StealPolicy::best_of_two;
+    // 自适应阈值：局部队列被窃取时阈值减半（让元素更早进入全局队列），合并期间无人窃取时阈值加倍（保持局部性），
+    // 范围为[local_threshold/16（至少1）, local_threshold*16]
+    bool adaptive_threshold = true;
+    // 局部队列非空持续超过该时间后整体合并到全局队列，限制元素在安静的生产者线程中滞留的时间；0表示不限制
+    std::chrono::milliseconds max_local_residence{ 10 };
+};
+
+// 内部统计计数的快照
+struct HierarchicalQueueStats
+{
+    std::uint64_t local_pops = 0;       // 从自己的局部队列出队
+    std::uint64_t global_pops = 0;      // 从全局队列出队
+    std::uint64_t steal_attempts = 0;   // 窃取尝试次数（局部与全局队列都取不到元素时）
+    std::uint64_t steal_successes = 0;  // 窃取成功次数
+    std::uint64_t items_stolen = 0;     // 窃取到的元素总数（含放入自己局部队列的部分）
+    std::uint64_t merges = 0;           // 局部队列整体合并到全局队列的次数（阈值、滞留时间、线程退出）
+    std::uint64_t timed_out_waits = 0;  // wait_and_pop等待超时的次数
+};
+
+enum class HpqCounter
+{
+    local_pops,
+    global_pops,
+    steal_attempts,
+    steal_successes,
+    items_stolen,
+    merges,
+    timed_out_waits,
+    count
+};
+
+// 统计计数器。关闭统计时为空类型，所有操作为空函数，编译后不留任何开销
+template <bool Enabled>
+class HpqStatCounters
+{
+public:
+    void add(HpqCounter, std::uint64_t = 1) noexcept {}
+    void add_shared(HpqCounter, std::uint64_t = 1) noexcept {}
+    void collect(HierarchicalQueueStats&) const noexcept {}
+};
+
+template <>
+class HpqStatCounters<true>
+{
+    std::atomic<std::uint64_t> values_[static_cast<std::size_t>(HpqCounter::count)]{};
+
+public:
+    // 只由一个线程写入的计数器：普通读写即可，避免原子读改写
+    void add(HpqCounter counter, std::uint64_t n = 1) noexcept
+    {
+        auto& value = values_[static_cast<std::size_t>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // 多个线程共同写入的计数器
+    void add_shared(HpqCounter counter, std::uint64_t n = 1) noexcept
+    {
+        values_[static_cast<std::size_t>(counter)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void collect(HierarchicalQueueStats& stats) const noexcept
+    {
+        auto get = [this](HpqCounter counter) {
+            return values_[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+            };
+        stats.local_pops += get(HpqCounter::local_pops);
+        stats.global_pops += get(HpqCounter::global_pops);
+        stats.steal_attempts += get(HpqCounter::steal_attempts);
+        stats.steal_successes += get(HpqCounter::steal_successes);
+        stats.items_stolen += get(HpqCounter::items_stolen);
+        stats.merges += get(HpqCounter::merges);
+        stats.timed_out_waits += get(HpqCounter::timed_out_waits);
+    }
+};
+
+// 元素小而可平凡拷贝时，局部队列把队首发布到原子变量中，窃取者无需加锁即可比较各队列的队首
+template <typename T, typename = void>
+struct can_publish_top : std::false_type {};
+
+template <typename T>
+struct can_publish_top<T, std::enable_if_t<std::is_trivially_copyable_v<T>&& std::is_default_constructible_v<T>>>
+    : std::bool_constant<std::atomic<T>::is_always_lock_free> {};
 
 // 线程局部队列的包装器，包含队列、锁和非空状态
-template <typename T, typename Container, typename Compare>
+template <typename T, typename Container, typename Compare, bool EnableStats = false>
 struct ThreadLocalQueue
 {
-    using QueueType = std::priority_queue<T, Container, Compare>;
+    using QueueType = heap_engine_t<T, Container, Compare>;
+    static constexpr bool kPublishTop = can_publish_top<T>::value;
+    struct NoPublishedTop {};
 
     QueueType queue;
     std::recursive_mutex mutex;
     std::atomic<bool> is_non_empty{ false };  // 标记队列是否非空
     std::thread::id owner_id;  // 所属线程ID
+    std::size_t slot;          // 在所属实例中的槽位号（稠密编号，用于非空位图）
+    std::atomic<std::uint64_t>* non_empty_word;  // 非空位图中本队列所在的字
+    std::uint64_t non_empty_mask;                // 本队列在该字中的位
+    // 当前队首的快照（仅kPublishTop时存在，队列非空时有效，可能略有滞后）
+    [[no_unique_address]] std::conditional_t<kPublishTop, std::atomic<T>, NoPublishedTop> published_top;
+    // 队列最近一次从空变为非空的时刻（steady_clock纳秒数），作为队内最老元素入队时刻的保守估计
+    std::atomic<std::int64_t> non_empty_since{ 0 };
+    std::size_t threshold;            // 当前合并阈值（自适应时由所属线程在持有mutex时调整）
+    std::size_t steals_since_adapt = 0;  // 上次调整阈值以来被窃取的次数（持有mutex时访问）
+    // 滞留时间检查的节奏（只由所属线程在持有mutex时访问）：每age_check_stride次入队读一次时钟，
+    // 入队频繁时步长增大以减少读时钟的开销，入队稀疏时步长缩小到1，保证元素不会因为入队次数不够而一直滞留
+    std::size_t pushes_since_age_check = 0;
+    std::size_t age_check_stride = 1;
+    std::int64_t last_age_check_ns = 0;
+    [[no_unique_address]] HpqStatCounters<EnableStats> stats;  // 所属线程的统计计数（只由所属线程写入）
+
+    ThreadLocalQueue(std::thread::id id, std::size_t slot_index, std::atomic<std::uint64_t>* word,
+        std::size_t initial_threshold)
+        : owner_id(id),
+        slot(slot_index),
+        non_empty_word(word),
+        non_empty_mask(std::uint64_t(1) << (slot_index % 64)),
+        threshold(initial_threshold)
+    {
+    }
 
-    ThreadLocalQueue(std::thread::id id) : owner_id(id) {}
-
-    // 推送元素并更新非空状态
-    void push(const T& value)
+    // 推送元素并更新非空状态，返回队列此前是否为空
+    bool push(const T& value)
     {
         std::lock_guard<std::recursive_mutex> lock(mutex);
         bool was_empty = queue.empty();
         queue.push(value);
+        publish_top();
         if (was_empty)
         {
-            is_non_empty.store(true, std::memory_order_release);
+            set_non_empty(true);
         }
+        return was_empty;
     }
 
-    void push(T&& value)
+    bool push(T&& value)
     {
         std::lock_guard<std::recursive_mutex> lock(mutex);
         bool was_empty = queue.empty();
         queue.push(std::move(value));
+        publish_top();
         if (was_empty)
         {
-            is_non_empty.store(true, std::memory_order_release);
+            set_non_empty(true);
         }
+        return was_empty;
+    }
+
+    // 队列非空已持续的时间（纳秒），队列为空时返回0
+    std::int64_t non_empty_age(std::int64_t now_ns) const
+    {
+        if (empty_quick()) return 0;
+        return now_ns - non_empty_since.load(std::memory_order_relaxed);
     }
 
     // 尝试弹出一个元素
@@ -54,16 +193,19 @@ struct ThreadLocalQueue
         std::lock_guard<std::recursive_mutex> lock(mutex);
         if (queue.empty())
         {
-            is_non_empty.store(false, std::memory_order_release);
+            set_non_empty(false);
             return std::nullopt;
         }
 
-        T value = queue.top();
-        queue.pop();
+        T value = queue.extract_top();
 
         if (queue.empty())
         {
-            is_non_empty.store(false, std::memory_order_release);
+            set_non_empty(false);
+        }
+        else
+        {
+            publish_top();
         }
 
         return value;
@@ -75,21 +217,25 @@ struct ThreadLocalQueue
         std::lock_guard<std::recursive_mutex> lock(mutex);
         if (queue.empty())
         {
-            is_non_empty.store(false, std::memory_order_release);
+            set_non_empty(false);
             return 0;
         }
 
         size_t stolen = 0;
         while (stolen < max_steal && !queue.empty())
         {
-            target.push(queue.top());
-            queue.pop();
+            target.push(queue.extract_top());
             stolen++;
         }
+        ++steals_since_adapt;
 
         if (queue.empty())
         {
-            is_non_empty.store(false, std::memory_order_release);
+            set_non_empty(false);
+        }
+        else
+        {
+            publish_top();
         }
 
         return stolen;
@@ -107,10 +253,9 @@ struct ThreadLocalQueue
         std::lock_guard<std::recursive_mutex> lock(mutex);
         while (!queue.empty())
         {
-            target.push(queue.top());
-            queue.pop();
+            target.push(queue.extract_top());
         }
-        is_non_empty.store(false, std::memory_order_release);
+        set_non_empty(false);
     }
 
     std::size_t size()
@@ -123,48 +268,197 @@ struct ThreadLocalQueue
 
         return queue.size();
     }
+
+private:
+    // 发布当前队首，需持有mutex且队列非空
+    void publish_top()
+    {
+        if constexpr (kPublishTop)
+        {
+            published_top.store(queue.top(), std::memory_order_relaxed);
+        }
+    }
+
+    // 更新非空状态并同步到实例的非空位图，需持有mutex；状态不变时不触碰共享的位图字
+    void set_non_empty(bool non_empty)
+    {
+        if (is_non_empty.load(std::memory_order_relaxed) == non_empty)
+        {
+            return;
+        }
+        if (non_empty)
+        {
+            non_empty_since.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+        }
+        is_non_empty.store(non_empty, std::memory_order_release);
+        if (non_empty)
+        {
+            non_empty_word->fetch_or(non_empty_mask, std::memory_order_release);
+        }
+        else
+        {
+            non_empty_word->fetch_and(~non_empty_mask, std::memory_order_release);
+        }
+    }
 };
 
+// EnableStats为true时记录内部统计计数，可通过stats()查看；默认关闭，计数代码在编译期整体去除
 template <
     typename T,
     typename Container = std::vector<T>,
-    typename Compare = std::less<typename Container::value_type>
+    typename Compare = std::less<typename Container::value_type>,
+    bool EnableStats = false
 >
 class HierarchicalPriorityQueue
 {
 private:
-    using QueueType = std::priority_queue<T, Container, Compare>;
-    using LocalQueueType = ThreadLocalQueue<T, Container, Compare>;
+    using QueueType = heap_engine_t<T, Container, Compare>;
+    using LocalQueueType = ThreadLocalQueue<T, Container, Compare, EnableStats>;
+
+    // 实例的生存期记录，由实例与各线程的局部队列表共同持有。
+    // 线程退出时据此判断实例是否仍然存在，实例析构（或被移动）时在mutex保护下更新owner
+    struct Lifetime
+    {
+        std::mutex mutex;
+        HierarchicalPriorityQueue* owner;
+
+        explicit Lifetime(HierarchicalPriorityQueue* queue) : owner(queue) {}
+    };
+
+    struct LocalQueueRef
+    {
+        LocalQueueType* queue = nullptr;  // nullptr表示槽位已用完，该线程直接使用全局队列
+        std::shared_ptr<Lifetime> lifetime;
+    };
+
+    // 每个线程的局部队列表：实例ID -> 该实例在本线程的局部队列。
+    // 以实例ID区分不同的队列实例，同一线程使用多个实例时各自拥有独立的局部队列，元素不会串到其他实例。
+    // 实例ID全局递增、从不复用，实例销毁后残留的表项不会再被查到。
+    // 线程退出时表被析构，把本线程在各个仍存在的实例中的局部队列合并到全局队列并归还槽位。
+    struct LocalQueueTable
+    {
+        std::uint64_t cached_id = 0;              // 最近一次查找的实例ID（单项缓存，避免每次查哈希表）
+        LocalQueueType* cached_queue = nullptr;
+        std::unordered_map<std::uint64_t, LocalQueueRef> queues;
+        std::size_t purge_at = 16;                // 表项达到该数量时清理已销毁实例的表项
+
+        ~LocalQueueTable()
+        {
+            for (auto& [id, ref] : queues)
+            {
+                std::lock_guard<std::mutex> lock(ref.lifetime->mutex);
+                if (ref.lifetime->owner && ref.queue)
+                {
+                    ref.lifetime->owner->release_local_queue(ref.queue);
+                }
+            }
+        }
+
+        // 清除已销毁实例留下的表项
+        void purge()
+        {
+            for (auto it = queues.begin(); it != queues.end();)
+            {
+                bool alive;
+                {
+                    std::lock_guard<std::mutex> lock(it->second.lifetime->mutex);
+                    alive = it->second.lifetime->owner != nullptr;
+                }
+                it = alive ? std::next(it) : queues.erase(it);
+            }
+            purge_at = std::max<std::size_t>(16, queues.size() * 2);
+        }
+    };
 
-    // 线程局部队列指针（每个线程拥有一个）
-    thread_local static inline std::unique_ptr<LocalQueueType> local_queue_;
+    static LocalQueueTable& local_table()
+    {
+        thread_local LocalQueueTable table;
+        return table;
+    }
+
+    static inline std::atomic<std::uint64_t> next_instance_id_{ 1 };
+    std::uint64_t instance_id_ = next_instance_id_.fetch_add(1, std::memory_order_relaxed);
 
     // 全局队列及同步机制
     QueueType global_queue_;
     mutable std::mutex global_mutex_;
     std::condition_variable global_cond_;
 
-    // 非空局部队列列表及同步机制
-    std::vector<LocalQueueType*> non_empty_local_queues_;
-    mutable std::mutex non_empty_mutex_;
+    // 局部队列槽位表：每个线程首次使用本实例时分配一个稠密的槽位号，
+    // 非空位图的第i位表示槽位i的局部队列非空，窃取者扫描位图即可找到目标，无需全局锁。
+    // 槽位数量在构造时固定，超出容量的线程不使用局部队列，直接读写全局队列。
+    // 线程退出后其槽位被回收，新线程优先复用编号最小的空闲槽位，位图扫描范围只到已用槽位的最高位，
+    // 因此扫描开销与同时存活的线程数成正比，而不是与历史上用过队列的线程数成正比。
+    struct SlotTable
+    {
+        std::size_t capacity;
+        std::unique_ptr<std::atomic<LocalQueueType*>[]> queues;      // 槽位 -> 局部队列（发布后不再改变，槽位复用时沿用同一对象）
+        std::unique_ptr<std::atomic<std::uint64_t>[]> non_empty;    // 非空位图
+        std::atomic<std::size_t> used{ 0 };                          // 曾经分配过的最高槽位号+1
+
+        explicit SlotTable(std::size_t slots)
+            : capacity(slots),
+            queues(new std::atomic<LocalQueueType*>[slots]),
+            non_empty(new std::atomic<std::uint64_t>[(slots + 63) / 64])
+        {
+            for (std::size_t i = 0; i < capacity; ++i) queues[i].store(nullptr, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < words(); ++i) non_empty[i].store(0, std::memory_order_relaxed);
+        }
+
+        std::size_t words() const { return (capacity + 63) / 64; }
+
+        // 需要扫描的位图字数
+        std::size_t used_words() const { return (used.load(std::memory_order_acquire) + 63) / 64; }
+    };
+    std::unique_ptr<SlotTable> slots_;
 
-    // 所有线程的局部队列映射
-    std::unordered_map<std::thread::id, LocalQueueType*> all_local_queues_;
-    mutable std::mutex all_queues_mutex_;
+    // 所有线程的局部队列，按槽位号排列（局部队列由实例持有，随实例一起销毁）。
+    // 不按std::thread::id索引：线程退出后其ID可能被新线程复用，而旧队列仍可能留有元素
+    std::vector<std::unique_ptr<LocalQueueType>> all_local_queues_;
+    std::vector<std::size_t> free_slots_;  // 已退出线程归还的槽位
+    mutable std::mutex all_queues_mutex_;  // 保护all_local_queues_、free_slots_与槽位分配
+
+    std::shared_ptr<Lifetime> lifetime_;
 
      size_t local_threshold_;      // 局部队列触发合并的阈值
      size_t max_steal_;            // 批量窃取的最大数量
      std::chrono::milliseconds wait_timeout_;  // 等待超时时间
+    StealPolicy steal_policy_;    // 窃取目标选择策略
+    bool adaptive_threshold_;     // 是否根据窃取/合并情况调整各局部队列的阈值
+    std::chrono::nanoseconds max_local_residence_;  // 局部队列非空的最长持续时间，0表示不限制
     Compare comp_;
 
+    // 没有局部队列的线程（槽位已用完）的统计计数
+    [[no_unique_address]] HpqStatCounters<EnableStats> overflow_stats_;
+
+    // 默认槽位数量：硬件线程数的2倍，至少64
+    static std::size_t default_max_local_queues()
+    {
+        return std::max<std::size_t>(64, 2 * std::thread::hardware_concurrency());
+    }
+
 public:
+    // max_local_queues：拥有局部队列的线程数上限，0表示使用默认值
     explicit HierarchicalPriorityQueue(
         size_t local_threshold = 100,
         size_t max_steal = 10,
-        std::chrono::milliseconds wait_timeout = std::chrono::milliseconds(100)
-    ) : local_threshold_(local_threshold),
-        max_steal_(max_steal),
-        wait_timeout_(wait_timeout)
+        std::chrono::milliseconds wait_timeout = std::chrono::milliseconds(100),
+        size_t max_local_queues = 0
+    ) : HierarchicalPriorityQueue(HierarchicalQueueOptions{ local_threshold, max_steal, wait_timeout, max_local_queues })
+    {
+    }
+
+    explicit HierarchicalPriorityQueue(const HierarchicalQueueOptions& options)
+        : slots_(std::make_unique<SlotTable>(
+            options.max_local_queues ? options.max_local_queues : default_max_local_queues())),
+        lifetime_(std::make_shared<Lifetime>(this)),
+        local_threshold_(options.local_threshold),
+        max_steal_(options.max_steal),
+        wait_timeout_(options.wait_timeout),
+        steal_policy_(options.steal_policy),
+        adaptive_threshold_(options.adaptive_threshold),
+        max_local_residence_(options.max_local_residence)
     {
         // 初始化当前线程的局部队列
         init_local_queue();
@@ -172,21 +466,19 @@ public:
 
     ~HierarchicalPriorityQueue()
     {
-        // 合并当前线程的局部队列到全局队列
-        if (local_queue_)
+        // 先标记实例已销毁，此后退出的线程不再访问本实例；若有线程正在退出并归还队列，等待其完成
         {
-            std::lock_guard<std::mutex> global_lock(global_mutex_);
-            local_queue_->merge_to(global_queue_);
+            std::lock_guard<std::mutex> lock(lifetime_->mutex);
+            lifetime_->owner = nullptr;
         }
 
-        // 从全局列表中移除当前线程的局部队列
-        std::lock_guard<std::mutex> all_lock(all_queues_mutex_);
-        auto it = all_local_queues_.find(std::this_thread::get_id());
-        if (it != all_local_queues_.end())
+        // 清除当前线程的缓存，其余线程表中的残留表项因实例ID不再复用而不会被访问
+        auto& table = local_table();
+        table.queues.erase(instance_id_);
+        if (table.cached_id == instance_id_)
         {
-            remove_from_non_empty(it->second);
-            delete it->second;
-            all_local_queues_.erase(it);
+            table.cached_id = 0;
+            table.cached_queue = nullptr;
         }
     }
 
@@ -194,45 +486,73 @@ public:
     HierarchicalPriorityQueue(const HierarchicalPriorityQueue&) = delete;
     HierarchicalPriorityQueue& operator=(const HierarchicalPriorityQueue&) = delete;
 
-    HierarchicalPriorityQueue(HierarchicalPriorityQueue&& other) noexcept
+    // 移动后other仍可继续使用，需要为它分配新的槽位表与生存期记录，因此移动操作可能抛出std::bad_alloc。
+    // 所有分配都在修改任何状态之前完成，分配失败时this与other均保持原状
+    HierarchicalPriorityQueue(HierarchicalPriorityQueue&& other)
         : local_threshold_(other.local_threshold_),
         max_steal_(other.max_steal_),
         wait_timeout_(other.wait_timeout_),
+        steal_policy_(other.steal_policy_),
+        adaptive_threshold_(other.adaptive_threshold_),
+        max_local_residence_(other.max_local_residence_),
         comp_(std::move(other.comp_))
     {
+        auto other_lifetime = std::make_shared<Lifetime>(&other);
+        auto other_slots = std::make_unique<SlotTable>(other.slots_->capacity);
+
+        // 接管other的实例ID与生存期记录，使各线程表中指向other局部队列的表项继续有效；other换用新的ID
+        instance_id_ = other.instance_id_;
+        other.instance_id_ = next_instance_id_.fetch_add(1, std::memory_order_relaxed);
+        adopt_lifetime(other, std::move(other_lifetime));
+
         // 移动全局队列（需加锁）
-        std::lock_guard<std::mutex> global_lock(global_mutex_);
+        std::lock_guard<std::mutex> global_lock(other.global_mutex_);
         global_queue_ = std::move(other.global_queue_);
 
-        // 移动队列映射（需加锁）
-        std::lock_guard<std::mutex> all_lock(all_queues_mutex_);
+        // 移动队列映射与槽位表（需加锁），other换用同样容量的空槽位表以便继续使用
+        std::lock_guard<std::mutex> all_lock(other.all_queues_mutex_);
         all_local_queues_ = std::move(other.all_local_queues_);
-
-        // 移动非空队列列表（需加锁）
-        std::lock_guard<std::mutex> non_empty_lock(non_empty_mutex_);
-        non_empty_local_queues_ = std::move(other.non_empty_local_queues_);
+        free_slots_ = std::move(other.free_slots_);
+        other.free_slots_.clear();
+        slots_ = std::move(other.slots_);
+        other.slots_ = std::move(other_slots);
     }
 
-    HierarchicalPriorityQueue& operator=(HierarchicalPriorityQueue&& other) noexcept
+    HierarchicalPriorityQueue& operator=(HierarchicalPriorityQueue&& other)
     {
         if (this != &other)
         {
+            auto other_lifetime = std::make_shared<Lifetime>(&other);
+            auto other_slots = std::make_unique<SlotTable>(other.slots_->capacity);
+
             local_threshold_ = other.local_threshold_;
             max_steal_ = other.max_steal_;
             wait_timeout_ = other.wait_timeout_;
+            steal_policy_ = other.steal_policy_;
+            adaptive_threshold_ = other.adaptive_threshold_;
+            max_local_residence_ = other.max_local_residence_;
             comp_ = std::move(other.comp_);
 
+            // 原有的局部队列随赋值销毁，原实例ID随之作废；接管other的实例ID
+            instance_id_ = other.instance_id_;
+            other.instance_id_ = next_instance_id_.fetch_add(1, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(lifetime_->mutex);
+                lifetime_->owner = nullptr;
+            }
+            adopt_lifetime(other, std::move(other_lifetime));
+
             // 移动全局队列（需加锁）
-            std::lock_guard<std::mutex> global_lock(global_mutex_);
+            std::scoped_lock global_lock(global_mutex_, other.global_mutex_);
             global_queue_ = std::move(other.global_queue_);
 
-            // 移动队列映射（需加锁）
-            std::lock_guard<std::mutex> all_lock(all_queues_mutex_);
+            // 移动队列映射与槽位表（需加锁）
+            std::scoped_lock all_lock(all_queues_mutex_, other.all_queues_mutex_);
             all_local_queues_ = std::move(other.all_local_queues_);
-
-            // 移动非空队列列表（需加锁）
-            std::lock_guard<std::mutex> non_empty_lock(non_empty_mutex_);
-            non_empty_local_queues_ = std::move(other.non_empty_local_queues_);
+            free_slots_ = std::move(other.free_slots_);
+            other.free_slots_.clear();
+            slots_ = std::move(other.slots_);
+            other.slots_ = std::move(other_slots);
         }
         return *this;
     }
@@ -240,53 +560,35 @@ public:
     // 推送元素到局部队列,无需加锁，因为每个线程有自己的局部队列
     void push(const T& value)
     {
-        init_local_queue();  // 确保局部队列已初始化
-
-        local_queue_->push(value);
-
-        // 检查是否需要合并到全局队列
-        check_and_merge_local();
-
-        // 如果队列刚从空变为非空，添加到非空列表
-        if (local_queue_->size() == 1)
-        {
-            add_to_non_empty(local_queue_.get());
-        }
-
-        global_cond_.notify_one();  // 通知等待的消费者
+        push_local(value);
     }
 
     void push(T&& value)
     {
-        init_local_queue();  // 确保局部队列已初始化
-
-        local_queue_->push(std::move(value));
-
-        // 检查是否需要合并到全局队列
-        check_and_merge_local();
+        push_local(std::move(value));
+    }
 
-        // 如果队列刚从空变为非空，添加到非空列表
-        if (local_queue_->size() == 1)
+    // 直接放入全局队列，不经过当前线程的局部队列：提交线程自己不出队时使用（例如外部线程向执行器提交任务），
+    // 避免元素滞留在无人消费的局部队列中、排在已合并到全局队列的低优先级元素之后
+    void push_global(T value)
+    {
         {
-            add_to_non_empty(local_queue_.get());
+            std::lock_guard<std::mutex> lock(global_mutex_);
+            global_queue_.push(std::move(value));
         }
-
-        global_cond_.notify_one();  // 通知等待的消费者
+        global_cond_.notify_one();
     }
 
     // 非阻塞弹出元素
     std::optional<T> try_pop()
     {
         // 步骤1：先检查自己的局部队列
-        if (local_queue_ && !local_queue_->empty_quick())
+        LocalQueueType* local = local_queue();
+        if (local && !local->empty_quick())
         {
-            if (auto val = local_queue_->try_pop())
+            if (auto val = local->try_pop())
             {
-                // 如果队列已空，从非空列表中移除
-                if (local_queue_->empty_quick())
-                {
-                    remove_from_non_empty(local_queue_.get());
-                }
+                record(HpqCounter::local_pops);
                 return val;
             }
         }
@@ -296,9 +598,8 @@ public:
             std::lock_guard<std::mutex> lock(global_mutex_);
             if (!global_queue_.empty())
             {
-                T val = global_queue_.top();
-                global_queue_.pop();
-                return val;
+                record(HpqCounter::global_pops);
+                return global_queue_.extract_top();
             }
         }
 
@@ -311,16 +612,16 @@ public:
     {
         while (true)
         {
+            // 每轮重新查找：本线程可能在窃取时才创建了局部队列（窃取剩余的元素放在其中）
+            LocalQueueType* local = local_queue();
+
             // 检查自己的局部队列
-            if (local_queue_ && !local_queue_->empty_quick())
+            if (local && !local->empty_quick())
             {
-                if (auto val = local_queue_->try_pop())
+                if (auto val = local->try_pop())
                 {
-                    if (local_queue_->empty_quick())
-                    {
-                        remove_from_non_empty(local_queue_.get());
-                    }
-                    return *val;
+                    record(HpqCounter::local_pops);
+                    return std::move(*val);
                 }
             }
 
@@ -329,31 +630,44 @@ public:
                 std::lock_guard<std::mutex> lock(global_mutex_);
                 if (!global_queue_.empty())
                 {
-                    T val = global_queue_.top();
-                    global_queue_.pop();
-                    return val;
+                    record(HpqCounter::global_pops);
+                    return global_queue_.extract_top();
                 }
             }
 
             // 尝试窃取
             if (auto val = steal_from_others())
             {
-                return *val;
+                return std::move(*val);
+            }
+
+            // 把滞留过久的局部队列合并到全局队列；有合并发生时直接重试
+            if (flush_aged_local_queues())
+            {
+                continue;
             }
 
-            // 所有队列都为空，等待通知或超时
+            // 所有队列都为空，等待通知或超时；限制滞留时间时至少每隔该时间醒来检查一次
+            auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(wait_timeout_);
+            if (max_local_residence_.count() > 0 && max_local_residence_ < timeout)
+            {
+                timeout = max_local_residence_;
+            }
             std::unique_lock<std::mutex> lock(global_mutex_);
-            global_cond_.wait_for(lock, wait_timeout_, [this] {
+            const bool woken = global_cond_.wait_for(lock, timeout, [this, local] {
                 // 检查全局队列
                 if (!global_queue_.empty()) return true;
 
                 // 检查自己的局部队列
-                if (local_queue_ && !local_queue_->empty_quick()) return true;
+                if (local && !local->empty_quick()) return true;
 
                 // 检查是否有其他非空局部队列
-                std::lock_guard<std::mutex> ne_lock(non_empty_mutex_);
-                return !non_empty_local_queues_.empty();
+                return any_non_empty();
                 });
+            if (!woken)
+            {
+                record(HpqCounter::timed_out_waits);
+            }
         }
     }
 
@@ -361,7 +675,8 @@ public:
     bool empty() const
     {
         // 检查自己的局部队列
-        if (local_queue_ && !local_queue_->empty_quick())
+        LocalQueueType* local = local_queue();
+        if (local && !local->empty_quick())
         {
             return false;
         }
@@ -374,8 +689,20 @@ public:
         }
 
         // 检查其他非空局部队列
-        std::lock_guard<std::mutex> ne_lock(non_empty_mutex_);
-        return non_empty_local_queues_.empty();
+        return !any_non_empty();
+    }
+
+    // 统计计数快照：汇总所有局部队列（包括已退出线程用过的）以及无局部队列线程的计数，仅EnableStats时可用
+    HierarchicalQueueStats stats() const requires EnableStats
+    {
+        HierarchicalQueueStats result;
+        std::lock_guard<std::mutex> lock(all_queues_mutex_);
+        for (const auto& queue : all_local_queues_)
+        {
+            queue->stats.collect(result);
+        }
+        overflow_stats_.collect(result);
+        return result;
     }
 
     // 获取估计的元素数量
@@ -384,10 +711,10 @@ public:
         size_t count = 0;
 
         // 自己的局部队列
-        if (local_queue_)
+        if (LocalQueueType* local = local_queue())
         {
-            std::lock_guard<std::recursive_mutex> lock(local_queue_->mutex);
-            count += local_queue_->queue.size();
+            std::lock_guard<std::recursive_mutex> lock(local->mutex);
+            count += local->queue.size();
         }
 
          // 全局队列
@@ -398,9 +725,10 @@ public:
 
         // 其他局部队列（只是估计值，不加锁）
         std::lock_guard<std::mutex> all_lock(all_queues_mutex_);
-        for (const auto& [id, queue] : all_local_queues_)
+        LocalQueueType* self = local_queue();
+        for (const auto& queue : all_local_queues_)
         {
-            if (id == std::this_thread::get_id()) continue;
+            if (queue.get() == self) continue;
             if (!queue->empty_quick())
             {
                 std::lock_guard<std::recursive_mutex> lock(queue->mutex);
@@ -412,130 +740,449 @@ public:
     }
 
 private:
-    // 初始化线程局部队列
-    void init_local_queue()
+    // 查找当前线程在本实例中的局部队列，尚未创建时返回nullptr
+    LocalQueueType* local_queue() const
     {
-        if (!local_queue_)
+        auto& table = local_table();
+        if (table.cached_id == instance_id_)
         {
-            auto id = std::this_thread::get_id();
-            local_queue_ = std::make_unique<LocalQueueType>(id);
+            return table.cached_queue;
+        }
+
+        auto it = table.queues.find(instance_id_);
+        if (it == table.queues.end())
+        {
+            return nullptr;
+        }
+        table.cached_id = instance_id_;
+        table.cached_queue = it->second.queue;
+        return it->second.queue;
+    }
 
-            // 添加到全局队列映射
+    // 初始化线程局部队列，槽位已用完时返回nullptr（该线程此后直接使用全局队列）
+    LocalQueueType* init_local_queue()
+    {
+        auto& table = local_table();
+        if (table.cached_id == instance_id_)
+        {
+            return table.cached_queue;
+        }
+        if (auto it = table.queues.find(instance_id_); it != table.queues.end())
+        {
+            table.cached_id = instance_id_;
+            table.cached_queue = it->second.queue;
+            return it->second.queue;
+        }
+
+        auto id = std::this_thread::get_id();
+        LocalQueueType* local = nullptr;
+
+        // 分配槽位并添加到全局队列映射：优先复用编号最小的空闲槽位，保持槽位稠密
+        {
             std::lock_guard<std::mutex> lock(all_queues_mutex_);
-            all_local_queues_[id] = local_queue_.get();
+            if (!free_slots_.empty())
+            {
+                auto it = std::min_element(free_slots_.begin(), free_slots_.end());
+                local = all_local_queues_[*it].get();
+                free_slots_.erase(it);
+
+                std::lock_guard<std::recursive_mutex> queue_lock(local->mutex);
+                local->owner_id = id;
+                local->threshold = local_threshold_;
+                local->steals_since_adapt = 0;
+            }
+            else if (all_local_queues_.size() < slots_->capacity)
+            {
+                const std::size_t slot = all_local_queues_.size();
+                auto queue = std::make_unique<LocalQueueType>(id, slot, &slots_->non_empty[slot / 64], local_threshold_);
+                local = queue.get();
+                all_local_queues_.push_back(std::move(queue));
+                slots_->queues[slot].store(local, std::memory_order_release);
+                slots_->used.store(slot + 1, std::memory_order_release);
+            }
+        }
+
+        if (table.queues.size() >= table.purge_at)
+        {
+            table.purge();
+        }
+        table.queues[instance_id_] = LocalQueueRef{ local, lifetime_ };
+        table.cached_id = instance_id_;
+        table.cached_queue = local;
+        return local;
+    }
+
+    // 线程退出时调用（持有lifetime_->mutex）：把该线程的局部队列合并到全局队列并归还槽位
+    void release_local_queue(LocalQueueType* local)
+    {
+        bool moved = false;
+        {
+            std::lock_guard<std::recursive_mutex> lock(local->mutex);
+            if (!local->queue.empty())
+            {
+                std::lock_guard<std::mutex> global_lock(global_mutex_);
+                local->merge_to(global_queue_);
+                moved = true;
+                // 线程退出途中不能再访问本线程的局部队列表，直接记在该队列上（写入者仍是所属线程）
+                local->stats.add(HpqCounter::merges);
+            }
+            local->owner_id = std::thread::id();
+        }
+        if (moved)
+        {
+            global_cond_.notify_all();
         }
+
+        std::lock_guard<std::mutex> lock(all_queues_mutex_);
+        free_slots_.push_back(local->slot);
     }
 
-    // 检查并合并局部队列到全局队列
-    void check_and_merge_local()
+    // 移动时接管other的生存期记录，other换用调用方预先分配好的新记录
+    void adopt_lifetime(HierarchicalPriorityQueue& other, std::shared_ptr<Lifetime> replacement)
     {
-        if (!local_queue_) return;
+        lifetime_ = std::move(other.lifetime_);
+        {
+            std::lock_guard<std::mutex> lock(lifetime_->mutex);
+            lifetime_->owner = this;
+        }
+        other.lifetime_ = std::move(replacement);
+    }
 
-        std::lock_guard<std::recursive_mutex> lock(local_queue_->mutex);
-        if (local_queue_->queue.size() >= local_threshold_)
+    template <typename U>
+    void push_local(U&& value)
+    {
+        LocalQueueType* local = init_local_queue();  // 确保局部队列已初始化
+        if (!local)
         {
+            // 槽位已用完，直接进入全局队列
+            {
+                std::lock_guard<std::mutex> lock(global_mutex_);
+                global_queue_.push(std::forward<U>(value));
+            }
+            global_cond_.notify_one();
+            return;
+        }
+
+        // 局部队列从空变为非空时会同时置位非空位图
+        const bool was_empty = local->push(std::forward<U>(value));
+
+        // 检查是否需要合并到全局队列
+        check_and_merge_local(local);
+
+        if (was_empty)
+        {
+            // 消费者在global_mutex_下检查位图后才睡眠，先经过一次该锁再通知，避免消费者错过这次通知而睡满超时
+            std::lock_guard<std::mutex> lock(global_mutex_);
+        }
+        global_cond_.notify_one();  // 通知等待的消费者
+    }
+
+    // 检查并合并局部队列到全局队列：达到阈值，或队列非空已超过最长滞留时间
+    void check_and_merge_local(LocalQueueType* local)
+    {
+        std::lock_guard<std::recursive_mutex> lock(local->mutex);
+        const std::size_t size = local->queue.size();
+
+        if (adaptive_threshold_ && local->steals_since_adapt > 0)
+        {
+            // 其他线程在窃取，说明它们缺活：降低阈值，让元素更早进入全局队列
+            local->threshold = std::max(min_threshold(), local->threshold / 2);
+            local->steals_since_adapt = 0;
+        }
+
+        bool merge = size >= local->threshold;
+        if (!merge && max_local_residence_.count() > 0 && ++local->pushes_since_age_check >= local->age_check_stride)
+        {
+            merge = residence_exceeded(local);
+        }
+
+        if (merge)
+        {
+            if (adaptive_threshold_ && size >= local->threshold)
+            {
+                // 攒满一批期间无人窃取：提高阈值，减少合并次数、保持局部性
+                local->threshold = std::min(max_threshold(), local->threshold * 2);
+            }
+
             std::lock_guard<std::mutex> global_lock(global_mutex_);
-            // 合并前先从非空列表移除
-            remove_from_non_empty(local_queue_.get());
-            // 执行合并
-            local_queue_->merge_to(global_queue_);
+            // 执行合并（同时清除非空位图中的对应位）
+            local->merge_to(global_queue_);
+            local->stats.add(HpqCounter::merges);
             // 通知等待的消费者
             global_cond_.notify_one();
         }
     }
 
-    // 将队列添加到非空列表
-    void add_to_non_empty(LocalQueueType* queue)
+    // 按入队计数检查局部队列的滞留时间（需持有local->mutex），并根据两次检查的间隔调整检查步长：
+    // 间隔远小于滞留上限时步长加倍（最多32次入队读一次时钟），否则减半
+    bool residence_exceeded(LocalQueueType* local)
     {
-        std::lock_guard<std::mutex> lock(non_empty_mutex_);
-        // 检查是否已在列表中
-        auto it = std::find(non_empty_local_queues_.begin(),
-            non_empty_local_queues_.end(),
-            queue);
-        if (it == non_empty_local_queues_.end())
+        constexpr std::size_t max_stride = 32;
+        const std::int64_t now = now_ns();
+        const std::int64_t limit = max_local_residence_.count();
+        if (now - local->last_age_check_ns < limit / 4)
         {
-            non_empty_local_queues_.push_back(queue);
+            local->age_check_stride = std::min(max_stride, local->age_check_stride * 2);
         }
+        else
+        {
+            local->age_check_stride = std::max<std::size_t>(1, local->age_check_stride / 2);
+        }
+        local->last_age_check_ns = now;
+        local->pushes_since_age_check = 0;
+        return local->non_empty_age(now) > limit;
     }
 
-    // 将队列从非空列表移除
-    void remove_from_non_empty(LocalQueueType* queue)
+    // 把非空持续时间超过上限的局部队列合并到全局队列（消费者等待前调用），返回是否合并了元素
+    bool flush_aged_local_queues()
     {
-        std::lock_guard<std::mutex> lock(non_empty_mutex_);
-        auto it = std::find(non_empty_local_queues_.begin(),
-            non_empty_local_queues_.end(),
-            queue);
-        if (it != non_empty_local_queues_.end())
+        if (max_local_residence_.count() <= 0)
         {
-            non_empty_local_queues_.erase(it);
+            return false;
         }
+
+        const std::int64_t now = now_ns();
+        bool flushed = false;
+        for_each_victim(nullptr, [&](LocalQueueType* queue) {
+            if (queue->non_empty_age(now) <= max_local_residence_.count())
+            {
+                return false;
+            }
+            // 加锁顺序与check_and_merge_local一致：先局部队列后全局队列
+            std::unique_lock<std::recursive_mutex> queue_lock(queue->mutex, std::try_to_lock);
+            if (!queue_lock.owns_lock() || queue->queue.empty())
+            {
+                return false;
+            }
+            std::lock_guard<std::mutex> global_lock(global_mutex_);
+            queue->merge_to(global_queue_);
+            record(HpqCounter::merges);
+            flushed = true;
+            return false;
+            });
+
+        if (flushed)
+        {
+            global_cond_.notify_all();
+        }
+        return flushed;
     }
 
-    // 从其他线程的局部队列窃取元素
-    std::optional<T> steal_from_others()
+    // 记录当前线程的统计计数：有局部队列时记在自己的队列上，否则记在共享的计数器上
+    void record(HpqCounter counter, std::uint64_t n = 1)
     {
-        std::vector<LocalQueueType*> candidates;
+        if constexpr (EnableStats)
+        {
+            if (LocalQueueType* local = local_queue())
+            {
+                local->stats.add(counter, n);
+            }
+            else
+            {
+                overflow_stats_.add_shared(counter, n);
+            }
+        }
+    }
 
-        // 复制当前非空队列列表（减少锁持有时间）
+    std::size_t min_threshold() const
+    {
+        return std::max<std::size_t>(1, local_threshold_ / 16);
+    }
+
+    std::size_t max_threshold() const
+    {
+        return local_threshold_ > SIZE_MAX / 16 ? SIZE_MAX : local_threshold_ * 16;
+    }
+
+    static std::int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 是否存在非空的局部队列（只读位图，不加锁）
+    bool any_non_empty() const
+    {
+        for (std::size_t w = 0, words = slots_->used_words(); w < words; ++w)
         {
-            std::lock_guard<std::mutex> lock(non_empty_mutex_);
-            if (non_empty_local_queues_.empty())
+            if (slots_->non_empty[w].load(std::memory_order_acquire) != 0)
             {
-                return std::nullopt;
+                return true;
             }
-            candidates = non_empty_local_queues_;
         }
+        return false;
+    }
 
-        // 尝试从每个候选队列窃取
+    // 从其他线程的局部队列窃取元素
+    std::optional<T> steal_from_others()
+    {
+        LocalQueueType* self = local_queue();
         QueueType stolen_elements;  // 临时存储窃取的元素
-        for (LocalQueueType* queue : candidates)
+        record(HpqCounter::steal_attempts);
+
+        if (steal_policy_ != StealPolicy::first_found)
         {
-            // 跳过自己的队列
-            if (queue->owner_id == std::this_thread::get_id())
+            // 先按策略选出队首优先级最高的目标；目标在窃取前被清空时退回按顺序扫描
+            if (LocalQueueType* victim = select_victim(self))
             {
-                continue;
+                const std::size_t stolen = victim->steal(stolen_elements, max_steal_);
+                if constexpr (!LocalQueueType::kPublishTop)
+                {
+                    victim->mutex.unlock();  // select_victim返回时持有目标的锁
+                }
+                if (stolen > 0)
+                {
+                    return take_stolen(stolen_elements, stolen);
+                }
             }
+        }
 
-            std::size_t stolen = 0;
-            // 尝试批量窃取
+        LocalQueueType* found = nullptr;
+        for_each_victim(self, [&](LocalQueueType* queue) {
+            // 尝试批量窃取（位图只是提示，队列可能已被清空）
+            const std::size_t stolen = queue->steal(stolen_elements, max_steal_);
+            if (stolen > 0)
             {
-                std::lock_guard<std::recursive_mutex> lock(queue->mutex);
-                stolen = queue->steal(stolen_elements, max_steal_);
+                found = queue;
+                return true;
             }
+            return false;
+            });
+        if (found)
+        {
+            return take_stolen(stolen_elements, stolen_elements.size());
+        }
 
-            if (stolen > 0)
+        return std::nullopt;
+    }
+
+    // 按位图遍历其他线程的非空局部队列，f返回true时停止；从自己槽位的下一个字开始，分散不同窃取者的起点
+    template <typename F>
+    void for_each_victim(LocalQueueType* self, F&& f)
+    {
+        SlotTable& slots = *slots_;
+        const std::size_t words = slots.used_words();
+        if (words == 0) return;
+        const std::size_t start = self ? (self->slot / 64 + 1) % words : 0;
+
+        for (std::size_t i = 0; i < words; ++i)
+        {
+            const std::size_t w = (start + i) % words;
+            std::uint64_t bits = slots.non_empty[w].load(std::memory_order_acquire);
+            while (bits != 0)
             {
-                // 如果队列已空，从非空列表中移除
-                if (queue->empty_quick())
+                const std::size_t slot = w * 64 + std::countr_zero(bits);
+                bits &= bits - 1;
+
+                LocalQueueType* queue = slots.queues[slot].load(std::memory_order_acquire);
+                // 跳过自己的队列
+                if (queue == nullptr || queue == self)
+                {
+                    continue;
+                }
+                if (f(queue))
                 {
-                    remove_from_non_empty(queue);
+                    return;
                 }
+            }
+        }
+    }
 
-                // 返回窃取到的最高优先级元素
-                T result = stolen_elements.top();
-                stolen_elements.pop();
+    // 按窃取策略选出队首优先级最高的目标队列。
+    // 队首已发布时只读原子快照，不加锁；否则用try_lock查看队首，始终只持有当前最优目标的锁，
+    // 此时返回的目标处于加锁状态，由调用者解锁
+    LocalQueueType* select_victim(LocalQueueType* self)
+    {
+        // best_of_two：蓄水池抽样选出两个候选
+        LocalQueueType* sampled[2] = { nullptr, nullptr };
+        std::size_t seen = 0;
 
-                // 将剩余窃取的元素放入自己的局部队列
-                if (local_queue_)
+        LocalQueueType* best = nullptr;
+        auto consider = [&](LocalQueueType* queue) {
+            if constexpr (LocalQueueType::kPublishTop)
+            {
+                if (queue->empty_quick()) return;
+                if (!best || comp_(best->published_top.load(std::memory_order_relaxed),
+                    queue->published_top.load(std::memory_order_relaxed)))
+                {
+                    best = queue;
+                }
+            }
+            else
+            {
+                if (!queue->mutex.try_lock()) return;
+                if (queue->queue.empty() || (best && !comp_(best->queue.top(), queue->queue.top())))
                 {
-                    std::lock_guard<std::recursive_mutex> lock(local_queue_->mutex);
-                    while (!stolen_elements.empty())
-                    {
-                        local_queue_->queue.push(stolen_elements.top());
-                        stolen_elements.pop();
-                    }
-                    // 如果自己的队列刚从空变为非空，添加到非空列表
-                    if (local_queue_->queue.size() == stolen - 1)
-                    {
-                        add_to_non_empty(local_queue_.get());
-                    }
+                    queue->mutex.unlock();
+                    return;
                 }
+                if (best) best->mutex.unlock();
+                best = queue;
+            }
+            };
 
-                return result;
+        for_each_victim(self, [&](LocalQueueType* queue) {
+            if (steal_policy_ == StealPolicy::best)
+            {
+                consider(queue);
             }
+            else if (seen < 2)
+            {
+                sampled[seen++] = queue;
+            }
+            else
+            {
+                const std::size_t r = random_index(++seen);
+                if (r < 2) sampled[r] = queue;
+            }
+            return false;
+            });
+
+        for (LocalQueueType* queue : sampled)
+        {
+            if (queue) consider(queue);
         }
+        return best;
+    }
 
-        return std::nullopt;
+    // 返回[0, n)内的伪随机数，仅用于抽样，线程各自一个生成器
+    static std::size_t random_index(std::size_t n)
+    {
+        thread_local std::minstd_rand gen(static_cast<unsigned>(
+            std::hash<std::thread::id>{}(std::this_thread::get_id())));
+        return gen() % n;
+    }
+
+    // 返回窃取到的最高优先级元素，其余元素放入自己的局部队列
+    std::optional<T> take_stolen(QueueType& stolen_elements, std::size_t stolen)
+    {
+        record(HpqCounter::steal_successes);
+        record(HpqCounter::items_stolen, stolen);
+
+        T result = stolen_elements.extract_top();
+
+        if (stolen > 1)
+        {
+            // 本线程尚未入队过时先创建局部队列；没有槽位时放回全局队列，避免丢失元素
+            if (LocalQueueType* local = init_local_queue())
+            {
+                std::lock_guard<std::recursive_mutex> lock(local->mutex);
+                while (!stolen_elements.empty())
+                {
+                    local->push(stolen_elements.extract_top());
+                }
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(global_mutex_);
+                while (!stolen_elements.empty())
+                {
+                    global_queue_.push(stolen_elements.extract_top());
+                }
+            }
+        }
+
+        return result;
     }
 };
 
@@ -0,0 +1,108 @@
+#pragma once
+#include <queue>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <cstddef>
+#include <type_traits>
+#include "dary_heap.h"
+#include "bucket_heap.h"
+
+/*
+优先级队列的堆引擎：在std::priority_queue的基础上暴露底层容器，
+提供批量入队（必要时整体堆化）和批量取出前k个元素的操作。
+所有成员函数都不加锁，由外层的线程安全队列负责同步。
+*/
+template <
+    typename T,
+    typename Container = std::vector<T>,
+    typename Compare = std::less<typename Container::value_type>
+>
+class BinaryHeap : public std::priority_queue<T, Container, Compare>
+{
+private:
+    using Base = std::priority_queue<T, Container, Compare>;
+
+public:
+    using Base::Base;
+
+    // 批量入队：先追加到容器尾部，再根据批量大小选择逐个上浮或整体堆化
+    // 逐个上浮的代价约为 m*log(n+m)，整体堆化为 O(n+m)，取较小者
+    template <typename InputIt>
+    void push_range(InputIt first, InputIt last)
+    {
+        const std::size_t old_size = this->c.size();
+        this->c.insert(this->c.end(), first, last);
+        const std::size_t new_size = this->c.size();
+        const std::size_t batch = new_size - old_size;
+        if (batch == 0) return;
+
+        if (should_heapify(old_size, batch))
+        {
+            std::make_heap(this->c.begin(), this->c.end(), this->comp);
+        }
+        else
+        {
+            for (std::size_t i = old_size + 1; i <= new_size; ++i)
+            {
+                std::push_heap(this->c.begin(), this->c.begin() + i, this->comp);
+            }
+        }
+    }
+
+    // 批量出队：依次取出最多k个优先级最高的元素写入out，返回实际取出的数量
+    template <typename OutputIt>
+    std::size_t pop_top_k(OutputIt out, std::size_t k)
+    {
+        std::size_t popped = 0;
+        while (popped < k && !this->c.empty())
+        {
+            std::pop_heap(this->c.begin(), this->c.end(), this->comp);
+            *out++ = std::move(this->c.back());
+            this->c.pop_back();
+            ++popped;
+        }
+        return popped;
+    }
+
+    // 移出堆顶元素（移动而非拷贝），支持只能移动的元素类型
+    T extract_top()
+    {
+        std::pop_heap(this->c.begin(), this->c.end(), this->comp);
+        T value = std::move(this->c.back());
+        this->c.pop_back();
+        return value;
+    }
+
+    Container& container() noexcept { return this->c; }
+    const Container& container() const noexcept { return this->c; }
+
+private:
+    // 批量占堆大小的比例足够大时整体堆化更划算：m*log2(n+m) > n+m
+    static bool should_heapify(std::size_t old_size, std::size_t batch)
+    {
+        const std::size_t total = old_size + batch;
+        std::size_t log2_total = 0;
+        for (std::size_t t = total; t > 1; t >>= 1) ++log2_total;
+        return batch * log2_total > total;
+    }
+};
+
+// 堆引擎选择：Container通过成员模板heap_engine声明自己对应的堆引擎（如DaryHeapContainer、BucketHeapContainer），
+// 未声明时使用二叉堆。新的堆引擎只需在其容器类型中声明heap_engine即可接入各个优先级队列。
+template <typename T, typename Container, typename Compare, typename = void>
+struct heap_engine_of
+{
+    using type = BinaryHeap<T, Container, Compare>;
+};
+
+template <typename T, typename Container, typename Compare>
+struct heap_engine_of<T, Container, Compare,
+    std::void_t<typename Container::template heap_engine<T, Container, Compare>>>
+{
+    using type = typename Container::template heap_engine<T, Container, Compare>;
+};
+
+template <typename T, typename Container, typename Compare>
+using heap_engine_t = typename heap_engine_of<T, Container, Compare>::type;
@@ -1,3 +1,4 @@
+#pragma once
 #include <queue>
 #include <mutex>
 #include <condition_variable>
@@ -6,6 +7,7 @@
 #include <stdexcept>
 #include <memory>
 #include"abstract_threadsafe_queue.h"
+#include"priority_heap.h"
 
 template <
     typename T,
@@ -15,9 +17,12 @@ template <
 class ThreadSafePriorityQueue 
 {
 private:
-    std::priority_queue<T, Container, Compare> queue_;  // 内部优先级队列
+    heap_engine_t<T, Container, Compare> queue_;        // 内部优先级队列（支持批量操作，Container决定堆引擎）
     mutable std::mutex mutex_;                          // 保护队列的互斥锁
-    std::condition_variable cond_var_;                  // 通知队列状态变化
+    std::condition_variable not_empty_cv_;              // 队列非空条件（消费者等待）
+    std::condition_variable not_full_cv_;               // 队列非满条件（有界队列的生产者等待）
+    size_t waiting_consumers_ = 0;                      // 正在等待非空条件的消费者数量
+    size_t waiting_producers_ = 0;                      // 正在等待非满条件的生产者数量
     const size_t max_size_;                             // 最大容量（0表示无界）
     bool is_bounded_;                                   // 是否为有界队列
 
@@ -57,13 +62,11 @@ public:
         // 有界队列需等待空间
         if (is_bounded_)
         {
-            cond_var_.wait(lock, [this] {
-                return queue_.size() < max_size_;
-                });
+            wait_not_full(lock);
         }
 
         queue_.push(std::move(value));
-        cond_var_.notify_one();  // 通知消费者有元素可用
+        notify_not_empty(1);  // 通知消费者有元素可用
     }
 
     // 移动版本的push（减少拷贝）
@@ -73,13 +76,11 @@ public:
 
         if (is_bounded_)
         {
-            cond_var_.wait(lock, [this] {
-                return queue_.size() < max_size_;
-                });
+            wait_not_full(lock);
         }
 
         queue_.push(std::move(value));
-        cond_var_.notify_one();
+        notify_not_empty(1);
     }
 
 
@@ -95,7 +96,7 @@ public:
         }
 
         queue_.push(value);
-        cond_var_.notify_one();
+        notify_not_empty(1);
         return true;
     }
 
@@ -109,11 +110,47 @@ public:
         }
 
         queue_.push(std::move(value));
-        cond_var_.notify_one();
+        notify_not_empty(1);
         return true;
     }
 
 
+    // 批量入队：整批元素只加一次锁
+    // 无界队列：一次性插入，批量较大时整体堆化
+    // 有界队列：每次等待到有空位后插入尽可能多的元素，直到全部插入
+    template <typename InputIt>
+    void push_range(InputIt first, InputIt last)
+    {
+        if (first == last) return;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!is_bounded_)
+        {
+            const size_t old_size = queue_.size();
+            queue_.push_range(first, last);
+            notify_not_empty(queue_.size() - old_size);
+            return;
+        }
+
+        std::vector<T> chunk;
+        while (first != last)
+        {
+            wait_not_full(lock);
+
+            chunk.clear();
+            const size_t space = max_size_ - queue_.size();
+            while (first != last && chunk.size() < space)
+            {
+                chunk.push_back(*first);
+                ++first;
+            }
+            queue_.push_range(std::make_move_iterator(chunk.begin()),
+                std::make_move_iterator(chunk.end()));
+            notify_not_empty(chunk.size());
+        }
+    }
+
+
     // 3. 出队操作（阻塞式）
     // 队列为空时阻塞，直到有元素可用，返回优先级最高的元素
     void wait_and_pop(T& value) 
@@ -121,35 +158,25 @@ public:
         std::unique_lock<std::mutex> lock(mutex_);
 
         // 等待队列非空
-        cond_var_.wait(lock, [this] {
-            return !queue_.empty();
-            });
+        wait_not_empty(lock);
 
         value = std::move(queue_.top());  // 获取优先级最高的元素
         queue_.pop();                     // 移除元素
 
         // 若为有界队列，出队后通知可能阻塞的生产者
-        if (is_bounded_)
-        {
-            cond_var_.notify_one();
-        }
+        notify_not_full(1);
     }
 
     // 返回智能指针（避免值类型的拷贝/移动，适用于大对象）
     std::shared_ptr<T> wait_and_pop() 
     {
         std::unique_lock<std::mutex> lock(mutex_);
-        cond_var_.wait(lock, [this] {
-            return !queue_.empty();
-            });
+        wait_not_empty(lock);
 
         auto result = std::make_shared<T>(std::move(queue_.top()));
         queue_.pop();
 
-        if (is_bounded_)
-        {
-            cond_var_.notify_one();
-        }
+        notify_not_full(1);
         return result;
     }
 
@@ -168,10 +195,7 @@ public:
         value = std::move(queue_.top());
         queue_.pop();
 
-        if (is_bounded_)
-        {
-            cond_var_.notify_one();
-        }
+        notify_not_full(1);
         return true;
     }
 
@@ -187,14 +211,32 @@ public:
         auto result = std::make_shared<T>(std::move(queue_.top()));
         queue_.pop();
 
-        if (is_bounded_)
-        {
-            cond_var_.notify_one();
-        }
+        notify_not_full(1);
         return result;
     }
 
 
+    // 批量出队（非阻塞式）：一次加锁取出最多k个优先级最高的元素，按优先级从高到低写入out
+    // 返回实际取出的元素数量，队列为空时返回0
+    template <typename OutputIt>
+    size_t pop_top_k(OutputIt out, size_t k)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const size_t popped = queue_.pop_top_k(out, k);
+
+        // 腾出了多少空位就唤醒多少生产者
+        notify_not_full(popped);
+        return popped;
+    }
+
+    // 追加到vector末尾的便捷版本
+    size_t pop_top_k(std::vector<T>& out, size_t k)
+    {
+        return pop_top_k(std::back_inserter(out), k);
+    }
+
+
     // 5. 队列状态查询
     bool empty() const 
     {
@@ -218,4 +260,57 @@ public:
         std::lock_guard<std::mutex> lock(mutex_);
         return max_size_ - queue_.size();
     }
+
+private:
+    // 生产者和消费者分别等待各自的条件变量，出队只会唤醒生产者，入队只会唤醒消费者，
+    // 避免单一条件变量下notify_one唤醒同类线程而导致的唤醒丢失。
+    // 等待者计数由mutex_保护，没有等待者时跳过notify，省去一次系统调用。
+    void wait_not_full(std::unique_lock<std::mutex>& lock)
+    {
+        ++waiting_producers_;
+        not_full_cv_.wait(lock, [this] {
+            return queue_.size() < max_size_;
+            });
+        --waiting_producers_;
+    }
+
+    void wait_not_empty(std::unique_lock<std::mutex>& lock)
+    {
+        ++waiting_consumers_;
+        not_empty_cv_.wait(lock, [this] {
+            return !queue_.empty();
+            });
+        --waiting_consumers_;
+    }
+
+    // 新增count个元素后唤醒min(count, 等待者数量)个消费者（需持有mutex_）
+    void notify_not_empty(size_t count)
+    {
+        const size_t wake = std::min(count, waiting_consumers_);
+        if (wake == waiting_consumers_ && wake > 1)
+        {
+            not_empty_cv_.notify_all();
+            return;
+        }
+        for (size_t i = 0; i < wake; ++i)
+        {
+            not_empty_cv_.notify_one();
+        }
+    }
+
+    // 腾出count个空位后唤醒min(count, 等待者数量)个生产者（需持有mutex_，仅对有界队列有效）
+    void notify_not_full(size_t count)
+    {
+        if (!is_bounded_) return;
+        const size_t wake = std::min(count, waiting_producers_);
+        if (wake == waiting_producers_ && wake > 1)
+        {
+            not_full_cv_.notify_all();
+            return;
+        }
+        for (size_t i = 0; i < wake; ++i)
+        {
+            not_full_cv_.notify_one();
+        }
+    }
 };
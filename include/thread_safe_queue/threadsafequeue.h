@@ -1,16 +1,73 @@
+#pragma once
 #include"abstract_threadsafe_queue.h"
+#include<deque>
+#include<optional>
+#include<coro/task.h>
 
 /*
 粗颗粒度的线程安全队列，采用全局互斥锁和条件变量实现,也是最简单的实现方式,最基础的线程安全的队列。
+协程通过co_await queue.async_pop()等待元素：队列为空时只挂起协程，不占用线程；
+push时元素优先直接交给等待最久的协程，并在该协程指定的线程池上恢复它。
 */
 template<typename T>
 class ThreadSafeQueue : public AbstractThreadSafeQueue<T>
 {
+public:
+    class PopAwaiter;
+
 private:
     std::queue<T> queue_; // 存储数据的队列
     mutable std::mutex mutex_; // 互斥锁，保护队列
     std::condition_variable cond_var_; // 条件变量，用于通知等待线程
+    std::deque<PopAwaiter*> pop_waiters_; // 挂起等待元素的协程（只在队列为空时非空）
+
 public:
+    // co_await async_pop()的等待体，位于挂起协程的帧中，恢复前一直有效
+    class PopAwaiter
+    {
+    private:
+        ThreadSafeQueue& queue_;
+        ThreadPool* executor_;
+        std::optional<T> value_;
+        std::coroutine_handle<> handle_;
+        friend class ThreadSafeQueue;
+
+    public:
+        PopAwaiter(ThreadSafeQueue& queue, ThreadPool* executor) : queue_(queue), executor_(executor) {}
+
+        bool await_ready()
+        {
+            std::lock_guard<std::mutex> lock(queue_.mutex_);
+            return take_locked();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            std::lock_guard<std::mutex> lock(queue_.mutex_);
+            if (take_locked())
+            {
+                return false;  // 判断与挂起之间有元素入队，不挂起
+            }
+            handle_ = handle;
+            queue_.pop_waiters_.push_back(this);
+            return true;
+        }
+
+        T await_resume() { return std::move(*value_); }
+
+    private:
+        bool take_locked()
+        {
+            if (queue_.queue_.empty())
+            {
+                return false;
+            }
+            value_.emplace(std::move(queue_.queue_.front()));
+            queue_.queue_.pop();
+            return true;
+        }
+    };
+
     //构造和析构函数
     ThreadSafeQueue() = default;
     ~ThreadSafeQueue() = default;
@@ -39,10 +96,31 @@ public:
     // 添加元素到队列
     void push(T value)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        queue_.push(std::move(value));
-        cond_var_.notify_all(); // 通知等待线程有新元素可用
-        //至于为什么不用notify_one()，因为如果wait_and_pop()线程抛出异常，那么刚push进来的元素仍停留在队列中，等待处理。
+        std::coroutine_handle<> waiting;
+        ThreadPool* executor = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pop_waiters_.empty())
+            {
+                queue_.push(std::move(value));
+                cond_var_.notify_all(); // 通知等待线程有新元素可用
+                //至于为什么不用notify_one()，因为如果wait_and_pop()线程抛出异常，那么刚push进来的元素仍停留在队列中，等待处理。
+                return;
+            }
+            // 有挂起的协程：元素直接交给等待最久的一个
+            PopAwaiter* waiter = pop_waiters_.front();
+            pop_waiters_.pop_front();
+            waiter->value_.emplace(std::move(value));
+            waiting = waiter->handle_;
+            executor = waiter->executor_;
+        }
+        resume_on(executor, waiting); // 解锁后再恢复，协程可能立即再次访问本队列
+    }
+
+    // 协程中等待并取出元素：co_await queue.async_pop()；元素到达后在executor上恢复协程
+    PopAwaiter async_pop(ThreadPool& executor = default_thread_pool())
+    {
+        return PopAwaiter(*this, &executor);
     }
 
     // 从队列中获取元素
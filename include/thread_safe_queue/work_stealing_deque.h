@@ -0,0 +1,169 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Chase-Lev动态循环工作窃取双端队列（内存序参照Lê等人的C11版本）。
+- 所有者线程在底部push/pop（后进先出，缓存友好）；其他线程（窃取者）在顶部steal（先进先出，拿走最早、通常最大的任务）。
+- 所有者的push/pop在无竞争时只有普通的原子读写，只有争抢最后一个元素时才需要一次CAS；窃取者之间通过top上的CAS互斥。
+- 缓冲区满时由所有者扩容为两倍。窃取者可能仍在读取旧数组，因此旧数组不立即释放，而是挂到退役列表中，
+  随双端队列析构统一释放；容量按倍数增长，退役数组的总大小小于当前数组，额外开销有界。
+- 窃取者读取槽位与所有者覆盖槽位可能并发，因此槽位是原子量，元素类型要求可平凡拷贝；
+  非平凡的任务请存放指针或下标。
+*/
+template <typename T>
+class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+        "WorkStealingDeque slots are atomic; store pointers or indices for non-trivial tasks");
+
+private:
+    // 循环数组：逻辑下标对容量取模，容量为2的幂
+    struct Array
+    {
+        std::int64_t capacity;
+        std::int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(std::int64_t cap) : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+        T get(std::int64_t i) const noexcept { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(std::int64_t i, T value) noexcept { slots[i & mask].store(value, std::memory_order_relaxed); }
+
+        // 扩容为两倍，并复制[top, bottom)中的元素（逻辑下标不变）
+        Array* grow(std::int64_t bottom, std::int64_t top) const
+        {
+            Array* bigger = new Array(capacity * 2);
+            for (std::int64_t i = top; i < bottom; ++i)
+            {
+                bigger->put(i, get(i));
+            }
+            return bigger;
+        }
+    };
+
+    alignas(64) std::atomic<std::int64_t> top_{ 0 };     // 窃取端，只增不减
+    alignas(64) std::atomic<std::int64_t> bottom_{ 0 };  // 所有者端
+    std::atomic<Array*> array_;
+    std::vector<std::unique_ptr<Array>> retired_;         // 只由所有者访问
+
+public:
+    // capacity：初始容量，向上取整为2的幂
+    explicit WorkStealingDeque(std::size_t capacity = 64)
+    {
+        std::int64_t cap = 1;
+        while (cap < static_cast<std::int64_t>(capacity))
+        {
+            cap <<= 1;
+        }
+        array_.store(new Array(cap), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    ~WorkStealingDeque()
+    {
+        delete array_.load(std::memory_order_relaxed);
+    }
+
+    // 仅所有者线程调用
+    void push(T value)
+    {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_acquire);
+        Array* a = array_.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1)
+        {
+            a = resize(a, b, t);
+        }
+        a->put(b, value);
+        // 以release发布槽位内容（等价于原算法的release栅栏+relaxed写，且能被ThreadSanitizer识别）
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    // 仅所有者线程调用：从底部取出最近push的元素，为空时返回std::nullopt
+    std::optional<T> pop()
+    {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // 已为空，恢复bottom
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> value = a->get(b);
+        if (t == b)
+        {
+            // 最后一个元素，与窃取者竞争
+            if (!top_.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                value.reset();
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    // 任意线程调用：从顶部窃取最早push的元素；为空或与其他线程竞争失败时返回std::nullopt
+    std::optional<T> steal()
+    {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b)
+        {
+            return std::nullopt;
+        }
+
+        // 先读再CAS：CAS成功说明读取时该槽位尚未被所有者取走或覆盖
+        Array* a = array_.load(std::memory_order_acquire);
+        const T value = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1,
+            std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    // 近似值，仅供监控与调度启发式使用
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    std::size_t size() const noexcept
+    {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+    // 仅所有者线程调用
+    std::size_t capacity() const noexcept
+    {
+        return static_cast<std::size_t>(array_.load(std::memory_order_relaxed)->capacity);
+    }
+
+private:
+    Array* resize(Array* old, std::int64_t b, std::int64_t t)
+    {
+        Array* bigger = old->grow(b, t);
+        retired_.emplace_back(old);
+        array_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+};
@@ -1,6 +1,9 @@
+#pragma once
 #include<exception>
 #include<thread>
 #include<mutex>
+#include<memory>
+#include<deque>
 #include<stack>
 #include<shared_mutex>
 
@@ -47,7 +50,7 @@ public:
 
     std::shared_ptr<T> pop()
     {
-        std::unique_lock<std::mutex> lock(mutex_);
+        std::unique_lock<std::shared_mutex> lock(mutex_);
         if (stack_.empty())
         {
             throw stack_empty();
@@ -59,7 +62,7 @@ public:
 
     void pop(T& value)
     {
-        std::unique_lock<std::mutex> lock(mutex_);
+        std::unique_lock<std::shared_mutex> lock(mutex_);
         if (stack_.empty())
         {
             throw stack_empty();
@@ -70,7 +73,7 @@ public:
 
     bool try_pop(T& value)
     {
-        std::unique_lock<std::mutex> lock(mutex_);
+        std::unique_lock<std::shared_mutex> lock(mutex_);
         if (stack_.empty())
         {
             return false;
@@ -82,7 +85,7 @@ public:
 
     bool try_pop(std::shared_ptr<T>& value)
     {
-        std::unique_lock<std::mutex> lock(mutex_);
+        std::unique_lock<std::shared_mutex> lock(mutex_);
         if (stack_.empty())
         {
             return false;
@@ -92,9 +95,41 @@ public:
         return true;
     }
 
+    // ջ⹹ֻһջΪʱֱӽӹO(1)
+    // ջ˳pushͬһԪλջ
+    template <typename InputIt>
+    void push_range(InputIt first, InputIt last)
+    {
+        std::deque<T> chain(first, last);
+        if (chain.empty())
+        {
+            return;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (stack_.empty())
+        {
+            stack_ = std::stack<T>(std::move(chain));
+            return;
+        }
+        for (auto& value : chain)
+        {
+            stack_.push(std::move(value)); // ڽִƶ
+        }
+    }
+
+    // һȡջO(1)صջǰջ
+    std::stack<T> pop_all()
+    {
+        std::stack<T> result;
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        stack_.swap(result);
+        return result;
+    }
+
     bool empty() const
     {
-        std::shared_lock<std::mutex> lock(mutex_);
+        std::shared_lock<std::shared_mutex> lock(mutex_);
         return stack_.empty();
     }
 };
@@ -0,0 +1,183 @@
+#include <thread_safe_queue/addressable_priority_queue.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <map>
+
+// 测试1：基础出队顺序
+TEST(AddressablePriorityQueueTest, PopsInPriorityOrder)
+{
+    AddressablePriorityQueue<std::string> queue;
+    queue.push("low", 1);
+    queue.push("high", 10);
+    queue.push("mid", 5);
+    EXPECT_EQ(queue.size(), 3u);
+
+    std::string value;
+    ASSERT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, "high");
+    ASSERT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, "mid");
+    ASSERT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, "low");
+    EXPECT_FALSE(queue.try_pop(value));
+}
+
+// 测试2：通过句柄提升和降低优先级，堆大小不变
+TEST(AddressablePriorityQueueTest, UpdatePriority)
+{
+    AddressablePriorityQueue<std::string> queue;
+    auto a = queue.push("a", 1);
+    auto b = queue.push("b", 2);
+    auto c = queue.push("c", 3);
+
+    EXPECT_TRUE(queue.update_priority(a, 100));  // 提升
+    EXPECT_TRUE(queue.update_priority(c, 0));    // 降低
+    EXPECT_EQ(queue.size(), 3u);
+    EXPECT_EQ(queue.priority(a), 100);
+
+    std::string value;
+    queue.try_pop(value);
+    EXPECT_EQ(value, "a");
+    queue.try_pop(value);
+    EXPECT_EQ(value, "b");
+    queue.try_pop(value);
+    EXPECT_EQ(value, "c");
+
+    // 元素出队后句柄失效
+    EXPECT_FALSE(queue.update_priority(b, 5));
+    EXPECT_FALSE(queue.contains(b));
+}
+
+// 测试3：按句柄删除，槽位复用后旧句柄不会误删新元素
+TEST(AddressablePriorityQueueTest, EraseAndStaleHandles)
+{
+    AddressablePriorityQueue<int> queue;
+    auto h1 = queue.push(1, 1);
+    auto h2 = queue.push(2, 2);
+    EXPECT_TRUE(queue.erase(h1));
+    EXPECT_FALSE(queue.erase(h1));
+    EXPECT_EQ(queue.size(), 1u);
+
+    // 新元素复用了h1的槽位
+    auto h3 = queue.push(3, 3);
+    EXPECT_EQ(h3.slot, h1.slot);
+    EXPECT_FALSE(queue.contains(h1));
+    EXPECT_FALSE(queue.erase(h1));
+    EXPECT_TRUE(queue.contains(h3));
+    EXPECT_TRUE(queue.contains(h2));
+
+    int value = 0;
+    queue.try_pop(value);
+    EXPECT_EQ(value, 3);
+    queue.try_pop(value);
+    EXPECT_EQ(value, 2);
+    EXPECT_TRUE(queue.empty());
+}
+
+// 测试4：随机的push/update/erase/pop与有序映射对照
+TEST(AddressablePriorityQueueTest, RandomizedAgainstReference)
+{
+    AddressablePriorityQueue<int, int, std::greater<int>> queue;  // 小顶堆
+    std::multimap<int, int> reference;  // priority -> value
+    std::vector<std::pair<AddressablePriorityQueue<int, int, std::greater<int>>::Handle, int>> live;
+    std::mt19937 gen(2024);
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        const int op = gen() % 4;
+        if (op == 0 || live.empty())
+        {
+            int priority = gen() % 1000;
+            live.push_back({ queue.push(step, priority), step });
+            reference.insert({ priority, step });
+        }
+        else if (op == 1)
+        {
+            size_t i = gen() % live.size();
+            auto old_priority = queue.priority(live[i].first);
+            if (!old_priority) continue;
+            int priority = gen() % 1000;
+            ASSERT_TRUE(queue.update_priority(live[i].first, priority));
+            auto range = reference.equal_range(*old_priority);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second == live[i].second)
+                {
+                    reference.erase(it);
+                    break;
+                }
+            }
+            reference.insert({ priority, live[i].second });
+        }
+        else if (op == 2)
+        {
+            size_t i = gen() % live.size();
+            auto old_priority = queue.priority(live[i].first);
+            if (!old_priority) continue;
+            ASSERT_TRUE(queue.erase(live[i].first));
+            auto range = reference.equal_range(*old_priority);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second == live[i].second)
+                {
+                    reference.erase(it);
+                    break;
+                }
+            }
+        }
+        else
+        {
+            int value = 0;
+            if (queue.try_pop(value))
+            {
+                ASSERT_FALSE(reference.empty());
+                // 最小优先级可能有多个元素，校验弹出的元素属于最小优先级
+                auto range = reference.equal_range(reference.begin()->first);
+                bool found = false;
+                for (auto it = range.first; it != range.second; ++it)
+                {
+                    if (it->second == value)
+                    {
+                        reference.erase(it);
+                        found = true;
+                        break;
+                    }
+                }
+                ASSERT_TRUE(found);
+            }
+        }
+        ASSERT_EQ(queue.size(), reference.size());
+    }
+}
+
+// 测试5：多线程并发更新优先级与出队
+TEST(AddressablePriorityQueueTest, ConcurrentUpdateAndPop)
+{
+    AddressablePriorityQueue<int> queue;
+    const int n = 10000;
+    std::vector<AddressablePriorityQueue<int>::Handle> handles;
+    for (int i = 0; i < n; ++i)
+    {
+        handles.push_back(queue.push(i, i));
+    }
+
+    std::thread updater([&] {
+        for (int i = 0; i < n; ++i)
+        {
+            queue.update_priority(handles[i], n - i);
+        }
+        });
+
+    std::vector<bool> seen(n, false);
+    for (int i = 0; i < n; ++i)
+    {
+        auto value = queue.wait_and_pop();
+        ASSERT_FALSE(seen[*value]);
+        seen[*value] = true;
+    }
+    updater.join();
+    EXPECT_TRUE(queue.empty());
+}
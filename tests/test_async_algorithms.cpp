@@ -0,0 +1,156 @@
+#include <parallel_algorithm/async_algorithms.h>
+#include <parallel_algorithm/for_each.h>
+#include <parallel_algorithm/prefix_sum.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <chrono>
+#include <stop_token>
+#include <iostream>
+
+std::vector<int> random_data(size_t n, unsigned seed = 42)
+{
+    std::mt19937 rng(seed);
+    std::vector<int> data(n);
+    for (auto& x : data) x = static_cast<int>(rng() % 1000000);
+    return data;
+}
+
+// 测试1：异步版本的结果与同步版本一致，可以用get()或在协程中co_await获取
+TEST(AsyncAlgorithmsTest, ResultsMatchBlockingVersions)
+{
+    ThreadPool pool(2);
+    const auto policy = execution::par.on(pool);
+    const auto data = random_data(200000);
+    auto expected = data;
+    std::sort(expected.begin(), expected.end());
+    const long long expected_sum = std::accumulate(data.begin(), data.end(), 0LL);
+
+    auto sorted = async_parallel_merge_sort(policy, data);
+    auto sum = async_parallel_accumulate(policy, data.begin(), data.end(), 0LL);
+    auto product = async_parallel_accumulate(policy, data.begin(), data.begin() + 10, 1.0, std::multiplies<double>());
+    EXPECT_EQ(sorted.get(), expected);
+    EXPECT_EQ(sum.get(), expected_sum);
+    EXPECT_DOUBLE_EQ(product.get(), std::accumulate(data.begin(), data.begin() + 10, 1.0, std::multiplies<double>()));
+
+    auto pipeline = [&]() -> task<long long> {
+        std::vector<int> ordered = co_await async_parallel_merge_sort(policy, data);
+        co_return co_await async_parallel_accumulate(policy, ordered.begin(), ordered.begin() + 1000, 0LL);
+        };
+    EXPECT_EQ(sync_wait(pipeline()), std::accumulate(expected.begin(), expected.begin() + 1000, 0LL));
+
+    // 没有工作线程时在调用线程执行完毕后返回
+    ThreadPool inline_pool(0);
+    auto inline_sum = async_parallel_accumulate(execution::par.on(inline_pool), data.begin(), data.end(), 0LL);
+    EXPECT_TRUE(inline_sum.ready());
+    EXPECT_EQ(inline_sum.get(), expected_sum);
+}
+
+// 测试2：停止请求生效后get()抛出operation_cancelled；同步版本通过执行策略的cancel_on同样可以取消
+TEST(AsyncAlgorithmsTest, CooperativeCancellation)
+{
+    ThreadPool pool(2);
+    const auto policy = execution::par.on(pool).grain(1000);
+    const auto data = random_data(1 << 20);
+
+    std::stop_source stopped;
+    stopped.request_stop();
+    EXPECT_THROW(async_parallel_merge_sort(policy, data, stopped.get_token()).get(), operation_cancelled);
+    EXPECT_THROW(async_parallel_accumulate(policy, data.begin(), data.end(), 0LL, stopped.get_token()).get(),
+        operation_cancelled);
+
+    auto copy = data;
+    const std::stop_token token = stopped.get_token();
+    EXPECT_THROW(parallel_merge_sort(policy.cancel_on(token), copy), operation_cancelled);
+    EXPECT_THROW(parallel_accumulate(execution::seq.cancel_on(token), data.begin(), data.end(), 0LL), operation_cancelled);
+
+    // 未请求停止时正常完成
+    std::stop_source running;
+    EXPECT_FALSE(std::is_sorted(data.begin(), data.end()));
+    auto sorted = async_parallel_merge_sort(policy, data, running.get_token()).get();
+    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
+
+    // 执行中途请求停止
+    std::stop_source source;
+    auto pending = async_parallel_merge_sort(policy, random_data(1 << 22, 7), source.get_token());
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    source.request_stop();
+    try
+    {
+        auto result = pending.get();
+        EXPECT_TRUE(std::is_sorted(result.begin(), result.end()));  // 停止请求到达前已经排完
+    }
+    catch (const operation_cancelled&)
+    {
+    }
+}
+
+// 测试3：for_each（静态与动态分割）和前缀和在串行、并行策略下都以operation_cancelled响应停止请求
+TEST(AsyncAlgorithmsTest, CancelOnForEachAndPrefix)
+{
+    ThreadPool pool(2);
+    std::stop_source stopped;
+    stopped.request_stop();
+    const std::stop_token token = stopped.get_token();
+    const auto data = random_data(100000);
+    std::atomic<size_t> visited{ 0 };
+    auto visit = [&](int) { visited.fetch_add(1, std::memory_order_relaxed); };
+
+    for (const auto& policy : { execution::seq.cancel_on(token), execution::par.on(pool).cancel_on(token) })
+    {
+        EXPECT_THROW(parallel_for_each_s(policy, data.begin(), data.end(), visit), operation_cancelled);
+        EXPECT_THROW(parallel_for_each_d(policy, data.begin(), data.end(), visit), operation_cancelled);
+        EXPECT_THROW(parallel_prefix(policy, data, std::plus<int>{}, 0), operation_cancelled);
+    }
+    EXPECT_EQ(visited.load(), 0u);
+
+    // 非取消的异常仍按原样包装
+    EXPECT_THROW(parallel_for_each_d(execution::par.on(pool), data.begin(), data.end(),
+        [](int) { throw std::logic_error("bad element"); }), std::runtime_error);
+}
+
+// 性能测试：排序与模拟I/O（sleep）串行执行与重叠执行的总耗时，以及请求停止到get()返回的延迟
+TEST(AsyncAlgorithmsTest, OverlapAndCancelLatencyBenchmark)
+{
+    using clock = std::chrono::steady_clock;
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    const auto policy = execution::par.on(pool);
+    const auto data = random_data(1 << 22);
+    const auto io = std::chrono::milliseconds(100);
+
+    auto start = clock::now();
+    auto blocking = data;
+    parallel_merge_sort(policy, blocking);
+    std::this_thread::sleep_for(io);
+    const double serial_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    start = clock::now();
+    auto pending = async_parallel_merge_sort(policy, data);
+    std::this_thread::sleep_for(io);
+    auto overlapped = pending.get();
+    const double overlap_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    EXPECT_EQ(blocking, overlapped);
+
+    std::stop_source source;
+    auto cancelled = async_parallel_merge_sort(policy, data, source.get_token());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    start = clock::now();
+    source.request_stop();
+    bool was_cancelled = false;
+    try
+    {
+        cancelled.get();
+    }
+    catch (const operation_cancelled&)
+    {
+        was_cancelled = true;
+    }
+    const double cancel_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    std::cout << "\nsort " << data.size() << " ints + " << io.count() << "ms I/O - blocking: " << serial_ms
+        << "ms, overlapped: " << overlap_ms << "ms; cancel latency: " << cancel_ms << "ms"
+        << (was_cancelled ? "" : " (finished before the stop request)") << "\n";
+}
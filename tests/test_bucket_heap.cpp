@@ -0,0 +1,182 @@
+#include <thread_safe_queue/thread_safe_priority_queue.h>
+#include <thread_safe_queue/bucket_heap.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+
+// 测试1：桶式堆默认键大者优先，与std::priority_queue约定一致
+TEST(BucketHeapTest, MaxFirstByDefault)
+{
+    ThreadSafePriorityQueue<int, BucketHeapContainer<int, 16>> queue;
+    for (int x : { 3, 15, 0, 7, 7, 1 }) queue.push(x);
+
+    std::vector<int> out;
+    queue.pop_top_k(out, 10);
+    EXPECT_EQ(out, (std::vector<int>{ 15, 7, 7, 3, 1, 0 }));
+    EXPECT_TRUE(queue.empty());
+}
+
+// 测试2：std::greater表示键小者优先，随机数据与排序结果一致
+TEST(BucketHeapTest, MinFirstRandomized)
+{
+    ThreadSafePriorityQueue<int, BucketHeapContainer<int, 1000>, std::greater<int>> queue;
+    std::mt19937 gen(5);
+    std::vector<int> reference;
+    std::vector<int> out;
+    for (int round = 0; round < 50; ++round)
+    {
+        // 入队与出队交替，检验游标在非单调情况下也正确
+        for (int i = 0; i < 100; ++i)
+        {
+            int x = gen() % 1000;
+            queue.push(x);
+            reference.push_back(x);
+        }
+        std::sort(reference.begin(), reference.end(), std::greater<int>());
+        for (int i = 0; i < 60; ++i)
+        {
+            int value = -1;
+            ASSERT_TRUE(queue.try_pop(value));
+            ASSERT_EQ(value, reference.back());
+            reference.pop_back();
+        }
+    }
+    EXPECT_EQ(queue.size(), reference.size());
+}
+
+// 测试3：自定义键提取，超出桶范围的键抛出异常
+struct Job
+{
+    int id;
+    unsigned priority;
+};
+
+struct JobPriority
+{
+    std::uint64_t operator()(const Job& job) const { return job.priority; }
+};
+
+TEST(BucketHeapTest, CustomKeyAndRangeCheck)
+{
+    ThreadSafePriorityQueue<Job, BucketHeapContainer<Job, 8, JobPriority>, std::greater<Job>> queue;
+    queue.push(Job{ 1, 5 });
+    queue.push(Job{ 2, 2 });
+    EXPECT_THROW(queue.push(Job{ 3, 8 }), std::out_of_range);
+
+    Job job{};
+    ASSERT_TRUE(queue.try_pop(job));
+    EXPECT_EQ(job.id, 2);
+    ASSERT_TRUE(queue.try_pop(job));
+    EXPECT_EQ(job.id, 1);
+}
+
+// 测试4：基数堆处理单调时间戳（模拟事件驱动仿真：出队后按当前时间推入未来事件）
+TEST(RadixHeapTest, MonotoneTimestamps)
+{
+    ThreadSafePriorityQueue<std::uint64_t, RadixHeapContainer<std::uint64_t>, std::greater<std::uint64_t>> queue;
+    std::mt19937_64 gen(9);
+    std::uint64_t now = 0;
+    queue.push(0);
+
+    std::uint64_t last = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        std::uint64_t t = 0;
+        ASSERT_TRUE(queue.try_pop(t));
+        ASSERT_GE(t, last);
+        last = t;
+        now = t;
+        // 每个事件产生0~2个未来事件，跨度覆盖多个数量级
+        const int spawn = (queue.empty() ? 1 : 0) + static_cast<int>(gen() % 2);
+        for (int j = 0; j < spawn; ++j)
+        {
+            queue.push(now + (gen() >> (24 + gen() % 40)));
+        }
+    }
+}
+
+// 测试5：基数堆拒绝小于当前基准的键
+TEST(RadixHeapTest, RejectsNonMonotoneKeys)
+{
+    ThreadSafePriorityQueue<std::uint64_t, RadixHeapContainer<std::uint64_t>, std::greater<std::uint64_t>> queue;
+    queue.push(10);
+    queue.push(20);
+    std::uint64_t t = 0;
+    ASSERT_TRUE(queue.try_pop(t));
+    EXPECT_EQ(t, 10u);
+    EXPECT_THROW(queue.push(5), std::invalid_argument);
+    queue.push(10);  // 等于最近出队的键仍然合法
+    ASSERT_TRUE(queue.try_pop(t));
+    EXPECT_EQ(t, 10u);
+    ASSERT_TRUE(queue.try_pop(t));
+    EXPECT_EQ(t, 20u);
+}
+
+// 测试6：多生产者多消费者下桶式堆不丢失元素
+TEST(BucketHeapTest, ConcurrentProducersConsumers)
+{
+    ThreadSafePriorityQueue<int, BucketHeapContainer<int, 64>> queue(32);
+    const int producers = 4, items = 10000;
+    std::atomic<long long> sum{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&] {
+            for (int i = 0; i < items; ++i) queue.push(i % 64);
+            });
+    }
+    for (int c = 0; c < producers; ++c)
+    {
+        threads.emplace_back([&] {
+            long long local = 0;
+            for (int i = 0; i < items; ++i)
+            {
+                int value = 0;
+                queue.wait_and_pop(value);
+                local += value;
+            }
+            sum += local;
+            });
+    }
+    for (auto& t : threads) t.join();
+
+    long long expected = 0;
+    for (int i = 0; i < items; ++i) expected += i % 64;
+    EXPECT_EQ(sum.load(), expected * producers);
+}
+
+// 性能测试：小整数优先级下桶式堆与二叉堆的入队+出队耗时
+template <typename Queue>
+long long push_pop_time_ms(const std::vector<int>& data)
+{
+    Queue queue;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int x : data) queue.push(x);
+    int value = 0;
+    while (queue.try_pop(value)) {}
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start
+    ).count();
+}
+
+TEST(BucketHeapTest, PerformanceComparison)
+{
+    const size_t n = 2'000'000;
+    std::vector<int> data(n);
+    std::mt19937 gen(1);
+    for (auto& x : data) x = gen() % 256;
+
+    auto binary_ms = push_pop_time_ms<ThreadSafePriorityQueue<int>>(data);
+    auto bucket_ms = push_pop_time_ms<ThreadSafePriorityQueue<int, BucketHeapContainer<int, 256>>>(data);
+
+    std::cout << "\nSmall integer priorities (" << n << " elements, 256 levels):\n";
+    std::cout << "Binary heap: " << binary_ms << "ms\n";
+    std::cout << "Bucket heap: " << bucket_ms << "ms\n";
+}
@@ -0,0 +1,156 @@
+#include <coro/task.h>
+#include <thread_safe_queue/threadsafequeue.h>
+#include <thread_safe_queue/bounded_threadsafe_queue.h>
+#include <thread_safe_queue/delay_queue.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <iostream>
+
+task<int> answer()
+{
+    co_return 42;
+}
+
+task<int> add_answers(int times)
+{
+    int total = 0;
+    for (int i = 0; i < times; ++i)
+    {
+        total += co_await answer();
+    }
+    co_return total;
+}
+
+task<void> fail()
+{
+    throw std::runtime_error("coroutine failed");
+    co_return;
+}
+
+// 测试1：task嵌套等待、异常传播，sync_wait与spawn获取结果
+TEST(CoroutineTest, TaskResultsAndExceptions)
+{
+    EXPECT_EQ(sync_wait(answer()), 42);
+    EXPECT_EQ(sync_wait(add_answers(1000)), 42000);
+    EXPECT_THROW(sync_wait(fail()), std::runtime_error);
+
+    ThreadPool pool(2);
+    auto on_pool = [&pool]() -> task<bool> {
+        co_await schedule_on(pool);
+        co_return pool.current_worker().has_value();
+        };
+    EXPECT_TRUE(spawn(pool, on_pool()).get());
+    EXPECT_THROW(spawn(pool, fail()).get(), std::runtime_error);
+}
+
+// 测试2：大量逻辑消费者协程在少量线程上等待同一个队列，每个元素恰好被消费一次
+task<void> consume(ThreadSafeQueue<int>& queue, ThreadPool& pool, std::atomic<long long>& sum, int items)
+{
+    for (int i = 0; i < items; ++i)
+    {
+        sum += co_await queue.async_pop(pool);
+    }
+}
+
+TEST(CoroutineTest, ThousandsOfConsumersShareFewThreads)
+{
+    ThreadPool pool(2);
+    ThreadSafeQueue<int> queue;
+    const int consumers = 2000, items_each = 10;
+    std::atomic<long long> sum{ 0 };
+
+    std::vector<std::future<void>> done;
+    for (int c = 0; c < consumers; ++c)
+    {
+        done.push_back(spawn(pool, consume(queue, pool, sum, items_each)));
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 2; ++p)
+    {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < consumers * items_each / 2; ++i) queue.push(p * 100000 + i);
+            });
+    }
+    for (auto& t : producers) t.join();
+    for (auto& f : done) f.get();
+
+    const long long half = consumers * items_each / 2;
+    EXPECT_EQ(sum.load(), half * (half - 1) + 100000 * half);
+    EXPECT_TRUE(queue.empty());
+}
+
+// 测试3：有界队列的async_push在队列满时挂起（背压），消费者取走元素后恢复
+TEST(CoroutineTest, BoundedQueueBackpressure)
+{
+    ThreadPool pool(2);
+    BoundedThreadSafeQueue<int, ThreadSafeQueue<int>> queue(4);
+    const int items = 1000;
+    std::atomic<int> max_seen{ 0 };
+
+    auto producer = [&]() -> task<void> {
+        for (int i = 1; i <= items; ++i)
+        {
+            co_await queue.async_push(i, pool);
+            const int size = static_cast<int>(queue.size());
+            int seen = max_seen.load();
+            while (size > seen && !max_seen.compare_exchange_weak(seen, size)) {}
+        }
+        };
+    auto consumer = [&]() -> task<long long> {
+        long long total = 0;
+        for (int i = 0; i < items; ++i)
+        {
+            total += co_await queue.async_pop(pool);
+        }
+        co_return total;
+        };
+
+    auto produced = spawn(pool, producer());
+    auto consumed = spawn(pool, consumer());
+    produced.get();
+    EXPECT_EQ(consumed.get(), static_cast<long long>(items) * (items + 1) / 2);
+    EXPECT_LE(max_seen.load(), 4);
+    EXPECT_TRUE(queue.empty());
+
+    // 协程生产者与阻塞的线程消费者混用
+    auto mixed = spawn(pool, producer());
+    long long total = 0;
+    for (int i = 0; i < items; ++i) total += *queue.wait_and_pop();
+    mixed.get();
+    EXPECT_EQ(total, static_cast<long long>(items) * (items + 1) / 2);
+}
+
+// 测试4：sleep_for与DelayQueue::async_pop按到期时间恢复协程
+TEST(CoroutineTest, SleepForAndDelayQueue)
+{
+    using namespace std::chrono_literals;
+    ThreadPool pool(2);
+
+    auto sleeper = [&]() -> task<std::chrono::steady_clock::duration> {
+        const auto start = std::chrono::steady_clock::now();
+        co_await sleep_for(30ms, pool);
+        co_return std::chrono::steady_clock::now() - start;
+        };
+    EXPECT_GE(spawn(pool, sleeper()).get(), 30ms);
+
+    DelayQueue<int> delayed;
+    auto take_three = [&]() -> task<std::vector<int>> {
+        std::vector<int> order;
+        for (int i = 0; i < 3; ++i) order.push_back(co_await delayed.async_pop(pool));
+        co_return order;
+        };
+    const auto start = std::chrono::steady_clock::now();
+    auto result = spawn(pool, take_three());  // 队列为空时开始等待
+    std::this_thread::sleep_for(5ms);
+    delayed.push(3, 60ms);
+    delayed.push(1, 20ms);
+    delayed.push(2, 40ms);
+    EXPECT_EQ(result.get(), (std::vector<int>{ 1, 2, 3 }));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 60ms);
+}
@@ -0,0 +1,103 @@
+#include <parallel_algorithm/execution_policy.h>
+#include <parallel_algorithm/accumulate.h>
+#include <parallel_algorithm/for_each.h>
+#include <parallel_algorithm/prefix_sum.h>
+#include <parallel_algorithm/merge_sort.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <list>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <set>
+#include <atomic>
+#include <stdexcept>
+
+// 测试1：构造器链式设置各字段，任务数受粒度、上限与执行器并发度共同约束
+TEST(ExecutionPolicyTest, BuildersAndTaskCount)
+{
+    ThreadPool pool(3);
+    const execution_policy policy = execution::par_unseq.threads(2).grain(100).on(pool);
+    EXPECT_EQ(policy.mode, execution_mode::parallel_unsequenced);
+    EXPECT_TRUE(policy.is_vectorized());
+    EXPECT_EQ(policy.max_threads, 2u);
+    EXPECT_EQ(policy.grain_size, 100u);
+    EXPECT_EQ(&policy.pool(), &pool);
+    EXPECT_EQ(&execution::par.pool(), &default_thread_pool());
+
+    EXPECT_EQ(policy.task_count(150, 25), 2u);                    // 上限2
+    EXPECT_EQ(policy.task_count(50, 25), 1u);                     // 粒度100
+    EXPECT_EQ(execution::par.on(pool).task_count(1000, 25), 4u);  // 并发度3+1
+    EXPECT_EQ(execution::par.on(pool).threads(16).task_count(1000, 25), 4u);
+    EXPECT_EQ(execution::seq.on(pool).task_count(1000, 25), 1u);
+    EXPECT_EQ(execution::par.task_count(0, 25), 1u);
+}
+
+// 测试2：三种执行方式在不同上限与粒度下结果与串行算法一致
+TEST(ExecutionPolicyTest, AllAlgorithmsMatchSerial)
+{
+    ThreadPool pool(3);
+    std::vector<int> data(50000);
+    std::iota(data.begin(), data.end(), 1);
+    const long long expected_sum = std::accumulate(data.begin(), data.end(), 0LL);
+    std::vector<long long> values(data.begin(), data.end());
+    auto add = [](long long a, long long b) { return a + b; };
+    const auto expected_prefix = sequential_prefix(values, add, 0LL);
+
+    for (const execution_policy base : { execution::seq, execution::par, execution::par_unseq })
+    {
+        for (const execution_policy policy : { base.on(pool), base.on(pool).threads(2), base.on(pool).grain(7) })
+        {
+            EXPECT_EQ(parallel_accumulate(policy, data.begin(), data.end(), 5LL), expected_sum + 5);
+
+            std::atomic<long long> visited{ 0 };
+            parallel_for_each_s(policy, data.begin(), data.end(), [&](int x) { visited += x; });
+            EXPECT_EQ(visited.load(), expected_sum);
+
+            std::list<int> items(data.begin(), data.end());
+            parallel_for_each_d(policy, items.begin(), items.end(), [](int& x) { x *= 2; });
+            EXPECT_EQ(std::accumulate(items.begin(), items.end(), 0LL), expected_sum * 2);
+
+            EXPECT_EQ(parallel_prefix(policy, values, add, 0LL), expected_prefix);
+
+            std::vector<int> shuffled = data;
+            std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(11));
+            parallel_merge_sort(policy.grain(policy.grain_or(1000)), shuffled);
+            EXPECT_EQ(shuffled, data);
+        }
+    }
+}
+
+// 测试3：sequential或任务数上限为1时全部在调用线程中执行，即使执行器有空闲工作线程
+TEST(ExecutionPolicyTest, SingleTaskRunsOnCaller)
+{
+    ThreadPool pool(3);
+    std::vector<int> data(10000, 1);
+    for (const execution_policy policy : { execution::seq.on(pool), execution::par.on(pool).threads(1),
+        execution::par.on(pool).grain(data.size()) })
+    {
+        std::mutex mutex;
+        std::set<std::thread::id> runners;
+        auto record = [&](int) {
+            std::lock_guard<std::mutex> lock(mutex);
+            runners.insert(std::this_thread::get_id());
+            };
+        parallel_for_each_s(policy, data.begin(), data.end(), record);
+        parallel_for_each_d(policy, data.begin(), data.end(), record);
+        EXPECT_EQ(runners, std::set<std::thread::id>{ std::this_thread::get_id() });
+    }
+}
+
+// 测试4：sequential执行时异常与并行执行时一样包装为runtime_error
+TEST(ExecutionPolicyTest, SequentialErrorsMatchParallel)
+{
+    std::vector<int> data(1000);
+    std::iota(data.begin(), data.end(), 0);
+    auto fail = [](int x) { if (x == 500) throw std::invalid_argument("bad element"); };
+    for (const execution_policy policy : { execution::seq, execution::par })
+    {
+        EXPECT_THROW(parallel_for_each_s(policy, data.begin(), data.end(), fail), std::runtime_error);
+        EXPECT_THROW(parallel_for_each_d(policy, data.begin(), data.end(), fail), std::runtime_error);
+    }
+}
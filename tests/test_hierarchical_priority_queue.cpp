@@ -0,0 +1,656 @@
+#include <thread_safe_queue/hierarchical_priority_queue.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <mutex>
+#include <cstdint>
+#include <future>
+#include <iostream>
+
+// 测试1：同一线程使用两个实例，元素不会串到另一个实例
+TEST(HierarchicalPriorityQueueTest, InstancesDoNotShareLocalQueues)
+{
+    HierarchicalPriorityQueue<int> a(100, 10);
+    HierarchicalPriorityQueue<int> b(100, 10);
+
+    a.push(1);
+    a.push(3);
+    b.push(2);
+
+    EXPECT_EQ(a.size(), 2u);
+    EXPECT_EQ(b.size(), 1u);
+
+    EXPECT_EQ(b.try_pop(), 2);
+    EXPECT_FALSE(b.try_pop().has_value());
+    EXPECT_TRUE(b.empty());
+
+    EXPECT_EQ(a.try_pop(), 3);
+    EXPECT_EQ(a.try_pop(), 1);
+    EXPECT_TRUE(a.empty());
+}
+
+// 测试2：实例销毁后新建实例，不会看到旧实例残留的元素
+TEST(HierarchicalPriorityQueueTest, FreshInstanceAfterDestroy)
+{
+    for (int round = 0; round < 100; ++round)
+    {
+        auto queue = std::make_unique<HierarchicalPriorityQueue<int>>(100, 10);
+        EXPECT_TRUE(queue->empty());
+        queue->push(round);
+        queue->push(round + 1);
+        // 留下元素直接销毁
+    }
+
+    HierarchicalPriorityQueue<int> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.size(), 0u);
+}
+
+// 测试3：移动后元素跟随目标实例，被移走的实例为空且可继续使用
+TEST(HierarchicalPriorityQueueTest, MoveKeepsLocalElements)
+{
+    HierarchicalPriorityQueue<int> a(100, 10);
+    a.push(5);
+    a.push(7);
+
+    HierarchicalPriorityQueue<int> b(std::move(a));
+    EXPECT_EQ(b.size(), 2u);
+    EXPECT_TRUE(a.empty());
+
+    a.push(1);
+    EXPECT_EQ(a.try_pop(), 1);
+    EXPECT_EQ(b.try_pop(), 7);
+
+    HierarchicalPriorityQueue<int> c;
+    c.push(100);
+    c = std::move(b);
+    EXPECT_EQ(c.try_pop(), 5);
+    EXPECT_FALSE(c.try_pop().has_value());
+}
+
+// 测试4：两个实例分别由多组线程并发读写，各自元素守恒
+TEST(HierarchicalPriorityQueueTest, ConcurrentInstancesConserveElements)
+{
+    HierarchicalPriorityQueue<int> a(16, 4, std::chrono::milliseconds(1));
+    HierarchicalPriorityQueue<int> b(16, 4, std::chrono::milliseconds(1));
+    const int threads_count = 4, items = 5000;
+    std::atomic<long long> sum_a{ 0 }, sum_b{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t)
+    {
+        // 每个生产者线程同时向两个实例写入
+        threads.emplace_back([&] {
+            for (int i = 1; i <= items; ++i)
+            {
+                a.push(i);
+                b.push(-i);
+            }
+            });
+    }
+    for (int t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back([&] {
+            long long local_a = 0, local_b = 0;
+            for (int i = 0; i < items; ++i)
+            {
+                local_a += a.wait_and_pop();
+                local_b += b.wait_and_pop();
+            }
+            sum_a += local_a;
+            sum_b += local_b;
+            });
+    }
+    for (auto& t : threads) t.join();
+
+    const long long expected = static_cast<long long>(items) * (items + 1) / 2 * threads_count;
+    EXPECT_EQ(sum_a.load(), expected);
+    EXPECT_EQ(sum_b.load(), -expected);
+    EXPECT_TRUE(a.empty());
+    EXPECT_TRUE(b.empty());
+}
+
+// 测试5：槽位用完后的线程直接使用全局队列，元素不丢失；其他线程可以窃取局部队列中的元素
+TEST(HierarchicalPriorityQueueTest, SlotOverflowFallsBackToGlobal)
+{
+    // 只有构造线程拥有局部队列
+    HierarchicalPriorityQueue<int> queue(100, 10, std::chrono::milliseconds(1), 1);
+    queue.push(1);
+    queue.push(2);
+
+    std::thread other([&] {
+        for (int i = 10; i < 20; ++i) queue.push(i);
+        // 窃取构造线程局部队列中的元素
+        std::vector<int> popped;
+        while (auto val = queue.try_pop()) popped.push_back(*val);
+        EXPECT_EQ(popped.size(), 12u);
+        EXPECT_EQ(popped.front(), 19);
+        });
+    other.join();
+    EXPECT_TRUE(queue.empty());
+}
+
+// 生产者压入元素后停住，直到消费结束才退出：线程退出时局部队列会被合并到全局队列，
+// 提前退出的话消费者直接从全局队列取，测不到窃取路径
+class ParkedProducers
+{
+    std::vector<std::thread> threads_;
+    std::atomic<int> ready_{ 0 };
+    std::promise<void> release_;
+    std::shared_future<void> gate_ = release_.get_future().share();
+
+public:
+    template <typename Push>
+    ParkedProducers(int count, Push push)
+    {
+        for (int p = 0; p < count; ++p)
+        {
+            threads_.emplace_back([this, push, p] {
+                push(p);
+                ++ready_;
+                gate_.wait();
+                });
+        }
+        while (ready_.load() < count) std::this_thread::yield();
+    }
+
+    ~ParkedProducers()
+    {
+        release_.set_value();
+        for (auto& t : threads_) t.join();
+    }
+};
+
+// 测试6：各窃取策略下只靠窃取也能取完所有元素；std::string走加锁查看队首的路径
+TEST(HierarchicalPriorityQueueTest, StealPoliciesConserveElements)
+{
+    for (StealPolicy policy : { StealPolicy::first_found, StealPolicy::best_of_two, StealPolicy::best })
+    {
+        HierarchicalQueueOptions options;
+        options.local_threshold = 1'000'000;  // 元素全部留在生产者的局部队列中
+        options.max_steal = 3;
+        options.steal_policy = policy;
+        options.max_local_residence = std::chrono::milliseconds(0);
+        HierarchicalPriorityQueue<std::string, std::vector<std::string>, std::less<std::string>, true> queue(options);
+
+        const int producers = 4, items = 500;
+        ParkedProducers parked(producers, [&](int p) {
+            for (int i = 0; i < items; ++i) queue.push(std::to_string(p * items + i));
+            });
+
+        std::atomic<int> popped{ 0 };
+        std::vector<std::thread> threads;
+        for (int c = 0; c < 3; ++c)
+        {
+            threads.emplace_back([&] {
+                while (queue.try_pop()) ++popped;
+                });
+        }
+        for (auto& t : threads) t.join();
+
+        EXPECT_EQ(popped.load(), producers * items);
+        EXPECT_TRUE(queue.empty());
+        EXPECT_GT(queue.stats().steal_successes, 0u);
+        EXPECT_EQ(queue.stats().merges, 0u);
+    }
+}
+
+// 测试7：best策略在单个窃取者时总是选中队首最大的局部队列
+TEST(HierarchicalPriorityQueueTest, BestPolicyPicksHighestTop)
+{
+    HierarchicalQueueOptions options;
+    options.local_threshold = 1'000'000;
+    options.max_steal = 1;
+    options.steal_policy = StealPolicy::best;
+    options.max_local_residence = std::chrono::milliseconds(0);
+    HierarchicalPriorityQueue<int, std::vector<int>, std::less<int>, true> queue(options);
+
+    ParkedProducers parked(8, [&](int p) {
+        for (int i = 0; i < 10; ++i) queue.push(i * 8 + p);
+        });
+
+    // 构造线程的局部队列与全局队列都为空，每次窃取一个元素，出队顺序应严格递减
+    std::vector<int> popped;
+    while (auto val = queue.try_pop()) popped.push_back(*val);
+    ASSERT_EQ(popped.size(), 80u);
+    EXPECT_TRUE(std::is_sorted(popped.rbegin(), popped.rend()));
+    const auto stats = queue.stats();
+    EXPECT_EQ(stats.steal_successes, 80u);
+    EXPECT_EQ(stats.global_pops, 0u);
+}
+
+// 树状数组：统计当前仍在队列中、优先级高于出队元素的数量（秩误差）
+class RankCounter
+{
+    std::vector<int> tree_;
+
+public:
+    explicit RankCounter(int n) : tree_(n + 1, 0) {}
+
+    void add(int value, int delta)
+    {
+        for (int i = value + 1; i < static_cast<int>(tree_.size()); i += i & -i) tree_[i] += delta;
+    }
+
+    // 小于等于value的元素数量
+    int prefix(int value) const
+    {
+        int sum = 0;
+        for (int i = value + 1; i > 0; i -= i & -i) sum += tree_[i];
+        return sum;
+    }
+};
+
+struct StealRunResult
+{
+    double throughput;    // 百万次出队/秒
+    double mean_rank_error;
+    std::uint64_t steal_successes;
+};
+
+// 生产者把乱序的0..n-1全部留在各自的局部队列中并停住直到消费结束，消费者只能窃取；
+// measure_rank为true时记录每次出队时队列中比它大的元素个数（测量会串行化出队，吞吐量单独测）
+StealRunResult run_steal_benchmark(StealPolicy policy, bool measure_rank)
+{
+    const int producers = 8, consumers = 4, per_producer = 20000;
+    const int n = producers * per_producer;
+
+    std::vector<int> values(n);
+    for (int i = 0; i < n; ++i) values[i] = i;
+    std::shuffle(values.begin(), values.end(), std::mt19937(7));
+
+    HierarchicalQueueOptions options;
+    options.local_threshold = n + 1;
+    options.max_steal = 4;
+    options.steal_policy = policy;
+    options.max_local_residence = std::chrono::milliseconds(0);
+    HierarchicalPriorityQueue<int, std::vector<int>, std::less<int>, true> queue(options);
+
+    ParkedProducers parked(producers, [&](int p) {
+        for (int i = p * per_producer; i < (p + 1) * per_producer; ++i) queue.push(values[i]);
+        });
+    std::vector<std::thread> threads;
+
+    RankCounter present(n);
+    for (int v : values) present.add(v, 1);
+    std::mutex rank_mutex;
+    long long rank_sum = 0;
+    int remaining = n;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&] {
+            while (auto val = queue.try_pop())
+            {
+                if (measure_rank)
+                {
+                    std::lock_guard<std::mutex> lock(rank_mutex);
+                    rank_sum += remaining - present.prefix(*val);
+                    present.add(*val, -1);
+                    --remaining;
+                }
+            }
+            });
+    }
+    for (auto& t : threads) t.join();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start
+    ).count();
+
+    return { n / static_cast<double>(us > 0 ? us : 1), static_cast<double>(rank_sum) / n, queue.stats().steal_successes };
+}
+
+// 性能测试：不同窃取策略的吞吐量与优先级反转（平均秩误差）
+TEST(HierarchicalPriorityQueueTest, StealPolicyComparison)
+{
+    const std::pair<StealPolicy, const char*> policies[] = {
+        { StealPolicy::first_found, "first_found" },
+        { StealPolicy::best_of_two, "best_of_two" },
+        { StealPolicy::best, "best" },
+    };
+
+    std::cout << "\nSteal policy comparison (8 producers x 20000, 4 stealing consumers):\n";
+    for (const auto& [policy, name] : policies)
+    {
+        const auto timed = run_steal_benchmark(policy, false);
+        const auto ranked = run_steal_benchmark(policy, true);
+        EXPECT_GT(timed.steal_successes, 0u);
+        EXPECT_GT(ranked.steal_successes, 0u);
+        const auto throughput = timed.throughput;
+        const auto rank_error = ranked.mean_rank_error;
+        std::cout << name << ": " << throughput << " M pops/s, mean rank error " << rank_error << "\n";
+    }
+}
+
+// 测试8：消费者已在等待时，其他线程压入局部队列的元素能及时被取走，而不是等满wait_timeout
+TEST(HierarchicalPriorityQueueTest, WaitingConsumerWakesPromptly)
+{
+    HierarchicalQueueOptions options;
+    options.local_threshold = 1'000'000;
+    options.wait_timeout = std::chrono::seconds(5);
+    options.max_local_residence = std::chrono::milliseconds(5);
+    HierarchicalPriorityQueue<int> queue(options);
+
+    for (int round = 0; round < 20; ++round)
+    {
+        std::atomic<bool> done{ false };
+        std::thread consumer([&] {
+            EXPECT_EQ(queue.wait_and_pop(), round);
+            done = true;
+            });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        auto start = std::chrono::steady_clock::now();
+        std::thread producer([&] { queue.push(round); });
+        producer.join();
+        consumer.join();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_TRUE(done);
+        EXPECT_LT(elapsed, std::chrono::seconds(1));
+    }
+}
+
+// 测试9：自适应阈值与滞留时间合并开启时，边生产边窃取的元素守恒
+TEST(HierarchicalPriorityQueueTest, AdaptiveThresholdConservesElements)
+{
+    HierarchicalQueueOptions options;
+    options.local_threshold = 64;
+    options.max_steal = 8;
+    options.wait_timeout = std::chrono::milliseconds(1);
+    options.max_local_residence = std::chrono::milliseconds(1);
+    HierarchicalPriorityQueue<int> queue(options);
+
+    const int producers = 4, consumers = 4, items = 20000;
+    std::atomic<long long> sum{ 0 };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&] {
+            for (int i = 1; i <= items; ++i)
+            {
+                queue.push(i);
+                // 偶尔停顿，让滞留时间合并有机会发生
+                if (i % 5000 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(3));
+            }
+            });
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&] {
+            long long local = 0;
+            for (int i = 0; i < items; ++i) local += queue.wait_and_pop();
+            sum += local;
+            });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(sum.load(), static_cast<long long>(items) * (items + 1) / 2 * producers);
+    EXPECT_TRUE(queue.empty());
+}
+
+// 测试10：只能移动的元素类型（std::unique_ptr）可以走完入队、合并、窃取、出队的全部路径
+struct HpqJob
+{
+    int priority;
+    std::vector<char> payload;
+};
+
+struct HpqJobLess
+{
+    bool operator()(const std::unique_ptr<HpqJob>& a, const std::unique_ptr<HpqJob>& b) const
+    {
+        return a->priority < b->priority;
+    }
+};
+
+TEST(HierarchicalPriorityQueueTest, MoveOnlyElements)
+{
+    using JobPtr = std::unique_ptr<HpqJob>;
+    HierarchicalQueueOptions options;
+    options.local_threshold = 8;
+    options.max_steal = 4;
+    options.wait_timeout = std::chrono::milliseconds(1);
+    HierarchicalPriorityQueue<JobPtr, std::vector<JobPtr>, HpqJobLess> queue(options);
+
+    const int producers = 3, items = 1000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < items; ++i)
+            {
+                queue.push(std::make_unique<HpqJob>(HpqJob{ p * items + i, std::vector<char>(64) }));
+            }
+            });
+    }
+
+    std::atomic<int> popped{ 0 };
+    for (int c = 0; c < 2; ++c)
+    {
+        threads.emplace_back([&] {
+            for (int i = 0; i < producers * items / 2; ++i)
+            {
+                JobPtr job = queue.wait_and_pop();
+                ASSERT_TRUE(job);
+                EXPECT_EQ(job->payload.size(), 64u);
+                ++popped;
+            }
+            });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(popped.load(), producers * items);
+    EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+// 测试11：右值入队的元素在整条路径上不发生拷贝
+struct CopyCounted
+{
+    static inline std::atomic<int> copies{ 0 };
+    int key = 0;
+
+    CopyCounted() = default;
+    explicit CopyCounted(int k) : key(k) {}
+    CopyCounted(const CopyCounted& other) : key(other.key) { ++copies; }
+    CopyCounted(CopyCounted&&) noexcept = default;
+    CopyCounted& operator=(const CopyCounted& other)
+    {
+        key = other.key;
+        ++copies;
+        return *this;
+    }
+    CopyCounted& operator=(CopyCounted&&) noexcept = default;
+
+    bool operator<(const CopyCounted& other) const { return key < other.key; }
+};
+
+TEST(HierarchicalPriorityQueueTest, NoCopiesOnMovePath)
+{
+    HierarchicalQueueOptions options;
+    options.local_threshold = 16;
+    options.max_steal = 4;
+    HierarchicalPriorityQueue<CopyCounted> queue(options);
+    CopyCounted::copies = 0;
+
+    std::thread producer([&] {
+        for (int i = 0; i < 1000; ++i) queue.push(CopyCounted(i));
+        });
+    producer.join();
+    for (int i = 0; i < 500; ++i) queue.push(CopyCounted(i));
+
+    int count = 0;
+    std::thread stealer([&] {
+        // 只窃取一部分，剩余元素进入该线程的局部队列后再取出
+        for (int i = 0; i < 700; ++i)
+        {
+            if (queue.try_pop()) ++count;
+        }
+        });
+    stealer.join();
+    while (queue.try_pop()) ++count;
+
+    EXPECT_EQ(count, 1500);
+    EXPECT_EQ(CopyCounted::copies.load(), 0);
+}
+
+// 测试12：线程退出时局部队列中的元素合并到全局队列，之后按全局优先级顺序出队
+TEST(HierarchicalPriorityQueueTest, ThreadExitDrainsLocalQueue)
+{
+    HierarchicalQueueOptions options;
+    options.local_threshold = 1'000'000;
+    options.max_steal = 1;
+    options.steal_policy = StealPolicy::first_found;
+    options.max_local_residence = std::chrono::milliseconds(0);
+    options.max_local_queues = 2;  // 构造线程和一个工作线程，槽位需要被反复复用
+    HierarchicalPriorityQueue<int> queue(options);
+
+    for (int t = 0; t < 20; ++t)
+    {
+        std::thread worker([&, t] {
+            for (int i = 0; i < 5; ++i) queue.push(i * 20 + t);
+            });
+        worker.join();
+    }
+
+    // 元素若滞留在各自的局部队列中，按槽位窃取的顺序不会是全局有序的
+    std::vector<int> popped;
+    while (auto val = queue.try_pop()) popped.push_back(*val);
+    ASSERT_EQ(popped.size(), 100u);
+    EXPECT_TRUE(std::is_sorted(popped.rbegin(), popped.rend()));
+}
+
+// 测试13：线程频繁创建退出时槽位被复用，不会耗尽而退化为只用全局队列；实例先于线程销毁也安全
+TEST(HierarchicalPriorityQueueTest, ThreadChurnReusesSlots)
+{
+    HierarchicalQueueOptions options;
+    options.local_threshold = 16;
+    options.max_local_queues = 8;
+    options.wait_timeout = std::chrono::milliseconds(1);
+    auto queue = std::make_unique<HierarchicalPriorityQueue<int>>(options);
+
+    std::atomic<long long> sum{ 0 };
+    for (int round = 0; round < 50; ++round)
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&] {
+                for (int i = 1; i <= 100; ++i) queue->push(i);
+                long long local = 0;
+                for (int i = 0; i < 50; ++i) local += queue->wait_and_pop();
+                sum += local;
+                });
+        }
+        for (auto& t : threads) t.join();
+    }
+    long long remaining = 0;
+    while (auto val = queue->try_pop()) remaining += *val;
+    EXPECT_EQ(sum.load() + remaining, 50LL * 4 * 5050);
+
+    // 线程仍持有表项时销毁实例，线程随后退出不应访问已销毁的实例
+    std::atomic<bool> pushed{ false }, destroyed{ false };
+    std::thread late([&] {
+        queue->push(1);
+        pushed = true;
+        while (!destroyed) std::this_thread::yield();
+        });
+    while (!pushed) std::this_thread::yield();
+    queue.reset();
+    destroyed = true;
+    late.join();
+}
+
+// 测试14：开启统计时各项计数与实际操作一致
+TEST(HierarchicalPriorityQueueTest, StatsCountOperations)
+{
+    HierarchicalQueueOptions options;
+    options.local_threshold = 4;
+    options.max_steal = 2;
+    options.adaptive_threshold = false;
+    options.max_local_residence = std::chrono::milliseconds(0);
+    options.wait_timeout = std::chrono::milliseconds(1);
+    HierarchicalPriorityQueue<int, std::vector<int>, std::less<int>, true> queue(options);
+
+    // 构造线程：压入3个（留在局部队列），第4个触发合并，再压入1个
+    for (int i = 0; i < 5; ++i) queue.push(i);
+    auto stats = queue.stats();
+    EXPECT_EQ(stats.merges, 1u);
+
+    EXPECT_EQ(queue.try_pop(), 4);  // 局部队列
+    EXPECT_EQ(queue.try_pop(), 3);  // 全局队列
+    stats = queue.stats();
+    EXPECT_EQ(stats.local_pops, 1u);
+    EXPECT_EQ(stats.global_pops, 1u);
+
+    // 另一个线程压入3个后退出（线程退出时合并），再由构造线程取走
+    std::thread producer([&] {
+        for (int i = 10; i < 13; ++i) queue.push(i);
+        });
+    producer.join();
+    stats = queue.stats();
+    EXPECT_EQ(stats.merges, 2u);
+
+    // 工作线程压入并保持局部，构造线程通过窃取取得
+    std::atomic<bool> pushed{ false }, done{ false };
+    std::thread holder([&] {
+        queue.push(100);
+        queue.push(101);
+        queue.push(102);
+        pushed = true;
+        while (!done) std::this_thread::yield();
+        });
+    while (!pushed) std::this_thread::yield();
+
+    std::vector<int> popped;
+    while (auto val = queue.try_pop()) popped.push_back(*val);
+    done = true;
+    holder.join();
+    // 先取全局队列中的12、11、10、2、1、0，再窃取102、101（101放入自己的局部队列），最后窃取100
+    EXPECT_EQ(popped, (std::vector<int>{ 12, 11, 10, 2, 1, 0, 102, 101, 100 }));
+    stats = queue.stats();
+    EXPECT_EQ(stats.steal_successes, 2u);
+    EXPECT_EQ(stats.items_stolen, 3u);
+    EXPECT_EQ(stats.local_pops, 2u);
+    EXPECT_EQ(stats.global_pops, 7u);
+    EXPECT_EQ(stats.local_pops + stats.global_pops + stats.steal_successes, 2u + popped.size());
+
+    // 空队列等待超时
+    std::thread waiter([&] {
+        EXPECT_EQ(queue.wait_and_pop(), 7);
+        });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.push(7);
+    waiter.join();
+    EXPECT_GE(queue.stats().timed_out_waits, 1u);
+
+    // 关闭统计时计数器不占空间
+    static_assert(sizeof(ThreadLocalQueue<int, std::vector<int>, std::less<int>, false>)
+        < sizeof(ThreadLocalQueue<int, std::vector<int>, std::less<int>, true>));
+}
+
+// 测试15：生产者只压入少量元素、入队间隔较长时，滞留时间超限后的下一次入队就会合并到全局队列
+TEST(HierarchicalPriorityQueueTest, SparseProducerFlushesByAge)
+{
+    HierarchicalQueueOptions options;
+    options.local_threshold = 1000;
+    options.adaptive_threshold = false;
+    options.max_local_residence = std::chrono::milliseconds(5);
+    HierarchicalPriorityQueue<int, std::vector<int>, std::less<int>, true> queue(options);
+
+    queue.push(1);
+    EXPECT_EQ(queue.stats().merges, 0u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.push(2);
+    EXPECT_EQ(queue.stats().merges, 1u);
+
+    // 合并后重新计时，紧接着的入队不会再次合并
+    queue.push(3);
+    EXPECT_EQ(queue.stats().merges, 1u);
+}
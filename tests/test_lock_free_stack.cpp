@@ -0,0 +1,280 @@
+#include <lock_free_stack.h>
+#include <threadsafestack.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <iostream>
+
+// 测试1：单线程下后进先出，空栈行为与thread_safe_stack一致
+TEST(LockFreeStackTest, LifoOrder)
+{
+    lock_free_stack<int> stack;
+    EXPECT_TRUE(stack.empty());
+    for (int i = 0; i < 1000; ++i) stack.push(i);
+    EXPECT_FALSE(stack.empty());
+
+    for (int i = 999; i >= 0; --i)
+    {
+        auto value = stack.try_pop();
+        ASSERT_TRUE(value.has_value());
+        ASSERT_EQ(*value, i);
+    }
+    EXPECT_TRUE(stack.empty());
+    EXPECT_FALSE(stack.try_pop().has_value());
+
+    int value = 0;
+    EXPECT_FALSE(stack.try_pop(value));
+    EXPECT_THROW(stack.pop(value), stack_empty);
+    EXPECT_THROW(stack.pop(), stack_empty);
+}
+
+// 测试2：只能移动的元素，析构时销毁栈中剩余元素
+TEST(LockFreeStackTest, MoveOnlyAndDestruction)
+{
+    auto tracker = std::make_shared<int>(0);
+    {
+        lock_free_stack<std::unique_ptr<std::shared_ptr<int>>> stack;
+        for (int i = 0; i < 100; ++i)
+        {
+            stack.emplace(std::make_unique<std::shared_ptr<int>>(tracker));
+        }
+        EXPECT_EQ(tracker.use_count(), 101);
+        for (int i = 0; i < 40; ++i)
+        {
+            ASSERT_TRUE(stack.try_pop().has_value());
+        }
+        EXPECT_EQ(tracker.use_count(), 61);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+// 测试3：多生产者多消费者，每个元素恰好被弹出一次（节点复用与消除路径下均不丢失、不重复）
+TEST(LockFreeStackTest, ConcurrentPushPopConservesElements)
+{
+    lock_free_stack<int> stack;
+    const int threads = 8, items = 50000;
+    std::vector<std::atomic<int>> seen(threads * items);
+    std::atomic<int> popped{ 0 };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t] {
+            // 推入与弹出交替进行，使栈经常在空与非空之间切换，节点被反复回收复用
+            for (int i = 0; i < items; ++i)
+            {
+                stack.push(t * items + i);
+                if (auto value = stack.try_pop())
+                {
+                    seen[*value].fetch_add(1, std::memory_order_relaxed);
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            });
+    }
+    for (auto& w : workers) w.join();
+
+    while (auto value = stack.try_pop())
+    {
+        seen[*value].fetch_add(1, std::memory_order_relaxed);
+        popped.fetch_add(1, std::memory_order_relaxed);
+    }
+    EXPECT_EQ(popped.load(), threads * items);
+    for (auto& count : seen)
+    {
+        ASSERT_EQ(count.load(), 1);
+    }
+}
+
+// 测试4：单个消除槽位时仍然正确（强制大量push/pop在同一槽位配对）
+TEST(LockFreeStackTest, SingleEliminationSlot)
+{
+    lock_free_stack<std::string> stack(1);
+    const int producers = 4, items = 20000;
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> remaining{ producers * items };
+
+    std::vector<std::thread> workers;
+    for (int p = 0; p < producers; ++p)
+    {
+        workers.emplace_back([&] {
+            for (int i = 0; i < items; ++i) stack.push(std::to_string(i));
+            });
+        workers.emplace_back([&] {
+            long long local = 0;
+            while (remaining.load(std::memory_order_relaxed) > 0)
+            {
+                std::string value;
+                if (stack.try_pop(value))
+                {
+                    local += std::stoi(value);
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+            sum += local;
+            });
+    }
+    for (auto& w : workers) w.join();
+
+    EXPECT_TRUE(stack.empty());
+    EXPECT_EQ(sum.load(), static_cast<long long>(items) * (items - 1) / 2 * producers);
+}
+
+// 测试5：批量入栈与逐个入栈顺序一致，pop_all按出栈顺序取下整个栈（两种栈行为相同）
+template <typename Stack>
+std::vector<int> drain_all(Stack& stack)
+{
+    std::vector<int> out;
+    auto all = stack.pop_all();
+    while (!all.empty())
+    {
+        out.push_back(all.top());
+        all.pop();
+    }
+    return out;
+}
+
+template <typename Stack>
+void check_push_range_pop_all()
+{
+    Stack stack;
+    const std::vector<int> empty_range;
+    stack.push_range(empty_range.begin(), empty_range.end());
+    EXPECT_TRUE(stack.empty());
+    EXPECT_TRUE(drain_all(stack).empty());
+
+    const std::vector<int> burst{ 1, 2, 3 };
+    stack.push_range(burst.begin(), burst.end());   // 空栈上批量入栈
+    stack.push(4);
+    const std::vector<int> more{ 5, 6 };
+    stack.push_range(more.begin(), more.end());     // 非空栈上批量入栈
+    EXPECT_EQ(drain_all(stack), (std::vector<int>{ 6, 5, 4, 3, 2, 1 }));
+    EXPECT_TRUE(stack.empty());
+
+    stack.push(7);
+    int value = 0;
+    ASSERT_TRUE(stack.try_pop(value));
+    EXPECT_EQ(value, 7);
+}
+
+TEST(StackBatchTest, PushRangePopAllOrder)
+{
+    check_push_range_pop_all<thread_safe_stack<int>>();
+    check_push_range_pop_all<lock_free_stack<int>>();
+}
+
+// 测试6：pop_all未处理完的元素随batch析构，节点回到栈中复用
+TEST(StackBatchTest, LockFreeBatchReleasesNodes)
+{
+    auto tracker = std::make_shared<int>(0);
+    lock_free_stack<std::shared_ptr<int>> stack;
+    const std::vector<std::shared_ptr<int>> burst(50, tracker);
+    stack.push_range(burst.begin(), burst.end());
+    EXPECT_EQ(tracker.use_count(), 101);
+    {
+        auto all = stack.pop_all();
+        all.pop();
+        EXPECT_TRUE(stack.empty());
+        EXPECT_EQ(tracker.use_count(), 100);
+    }
+    EXPECT_EQ(tracker.use_count(), 51);
+    stack.push_range(burst.begin(), burst.end());
+    EXPECT_EQ(tracker.use_count(), 101);
+}
+
+// 测试7：生产者成批入栈、消费者整栈取走，多线程下元素不丢失、不重复
+template <typename Stack>
+void check_concurrent_batches()
+{
+    Stack stack;
+    const int producers = 4, bursts = 2000, burst_size = 16;
+    const int total = producers * bursts * burst_size;
+    std::vector<std::atomic<int>> seen(total);
+    std::atomic<int> consumed{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            std::vector<int> burst(burst_size);
+            for (int b = 0; b < bursts; ++b)
+            {
+                for (int i = 0; i < burst_size; ++i)
+                {
+                    burst[i] = (p * bursts + b) * burst_size + i;
+                }
+                stack.push_range(burst.begin(), burst.end());
+                stack.push_range(burst.begin(), burst.begin());
+            }
+            });
+    }
+    for (int c = 0; c < 2; ++c)
+    {
+        threads.emplace_back([&] {
+            while (consumed.load(std::memory_order_relaxed) < total)
+            {
+                auto all = stack.pop_all();
+                while (!all.empty())
+                {
+                    seen[all.top()].fetch_add(1, std::memory_order_relaxed);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                    all.pop();
+                }
+            }
+            });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(consumed.load(), total);
+    for (auto& count : seen)
+    {
+        ASSERT_EQ(count.load(), 1);
+    }
+}
+
+TEST(StackBatchTest, ConcurrentBurstsConserveElements)
+{
+    check_concurrent_batches<thread_safe_stack<int>>();
+    check_concurrent_batches<lock_free_stack<int>>();
+}
+
+// 性能测试：空闲链表式负载（每个线程反复push/pop），互斥锁栈与无锁栈的耗时
+template <typename Stack>
+long long push_pop_pairs_time_ms(int threads, int pairs)
+{
+    Stack stack;
+    std::vector<std::thread> workers;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&] {
+            int value = 0;
+            for (int i = 0; i < pairs; ++i)
+            {
+                stack.push(i);
+                stack.try_pop(value);
+            }
+            });
+    }
+    for (auto& w : workers) w.join();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start
+    ).count();
+}
+
+TEST(LockFreeStackTest, PerformanceComparison)
+{
+    const int pairs = 200000;
+    std::cout << "\nPush/pop pairs per thread: " << pairs << "\n";
+    for (int threads : { 1, 4, 8 })
+    {
+        auto mutex_ms = push_pop_pairs_time_ms<thread_safe_stack<int>>(threads, pairs);
+        auto lock_free_ms = push_pop_pairs_time_ms<lock_free_stack<int>>(threads, pairs);
+        std::cout << threads << " threads - thread_safe_stack: " << mutex_ms
+            << "ms, lock_free_stack: " << lock_free_ms << "ms\n";
+    }
+}
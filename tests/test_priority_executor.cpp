@@ -0,0 +1,164 @@
+#include <parallel_algorithm/priority_executor.h>
+#include <parallel_algorithm/thread_pool.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+
+// 让唯一的工作线程先阻塞在一个任务上，返回放行函数；期间提交的任务都在队列中排队
+std::function<void()> hold_worker(PriorityExecutor& executor)
+{
+    auto release = std::make_shared<std::promise<void>>();
+    std::promise<void> started;
+    auto running = started.get_future();
+    executor.post(0, [gate = release->get_future().share(), &started]() mutable {
+        started.set_value();
+        gate.wait();
+        });
+    running.wait();
+    return [release] { release->set_value(); };
+}
+
+// 测试1：后提交的高优先级任务越过已排队的低优先级任务，同一优先级内按提交顺序执行
+TEST(PriorityExecutorTest, UrgentTasksOvertakeBulk)
+{
+    PriorityExecutor::Options options;
+    options.threads = 1;
+    options.aging_interval = std::chrono::seconds(10);  // 测试期间老化可以忽略
+    PriorityExecutor executor(options);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) { return [&, id] { std::lock_guard<std::mutex> lock(mutex); order.push_back(id); }; };
+
+    auto release = hold_worker(executor);
+    for (int i = 0; i < 50; ++i) executor.post(0, record(i));
+    for (int i = 0; i < 5; ++i) executor.post(10, record(1000 + i));
+    executor.post(5, record(500));
+    release();
+    executor.submit(-1, [] {}).get();
+
+    ASSERT_EQ(order.size(), 56u);
+    for (int i = 0; i < 5; ++i) EXPECT_EQ(order[i], 1000 + i);
+    EXPECT_EQ(order[5], 500);
+    for (int i = 0; i < 50; ++i) EXPECT_EQ(order[6 + i], i);
+}
+
+// 测试2：老化：等待足够久的低优先级任务排在新提交的稍高优先级任务之前，但仍会被高得多的优先级越过
+TEST(PriorityExecutorTest, AgingPreventsStarvation)
+{
+    using namespace std::chrono_literals;
+    PriorityExecutor::Options options;
+    options.threads = 1;
+    options.aging_interval = 1ms;
+    PriorityExecutor executor(options);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) { return [&, id] { std::lock_guard<std::mutex> lock(mutex); order.push_back(id); }; };
+
+    auto release = hold_worker(executor);
+    executor.post(0, record(0));
+    std::this_thread::sleep_for(50ms);  // 相当于提升约50级
+    executor.post(5, record(5));
+    executor.post(1000, record(1000));
+    release();
+    executor.submit(-1000000, [] {}).get();
+
+    EXPECT_EQ(order, (std::vector<int>{ 1000, 0, 5 }));
+}
+
+// 测试3：结果与异常通过future返回；工作线程内提交的任务（进入局部队列）全部执行；析构前执行完剩余任务
+TEST(PriorityExecutorTest, NestedSubmitAndShutdown)
+{
+    std::atomic<int> done{ 0 };
+    {
+        PriorityExecutor executor(3);
+        EXPECT_EQ(executor.submit(1, [] { return 42; }).get(), 42);
+        EXPECT_THROW(executor.submit(1, [] { throw std::runtime_error("task failed"); }).get(), std::runtime_error);
+
+        auto spawner = executor.submit(0, [&] {
+            for (int i = 0; i < 200; ++i)
+            {
+                executor.post(i % 7, [&] { done++; });
+            }
+            });
+        spawner.get();
+        for (int i = 0; i < 300; ++i) executor.post(i % 3, [&] { done++; });
+    }
+    EXPECT_EQ(done.load(), 500);
+
+    // 没有工作线程时在提交线程执行
+    PriorityExecutor inline_executor(0);
+    int value = 0;
+    inline_executor.post(1, [&] { value = 7; });
+    EXPECT_EQ(value, 7);
+}
+
+// 测试4：极端优先级与较长的老化间隔相乘时排序键不溢出，仍按优先级执行，且都排在退出标记之前
+TEST(PriorityExecutorTest, ExtremePrioritiesDoNotOverflow)
+{
+    PriorityExecutor::Options options;
+    options.threads = 1;
+    options.aging_interval = std::chrono::hours(24);
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) { return [&, id] { std::lock_guard<std::mutex> lock(mutex); order.push_back(id); }; };
+    {
+        PriorityExecutor executor(options);
+        auto release = hold_worker(executor);
+        executor.post(std::numeric_limits<int>::min(), record(0));
+        executor.post(-1, record(1));
+        executor.post(1, record(2));
+        executor.post(std::numeric_limits<int>::max(), record(3));
+        release();
+    }
+    EXPECT_EQ(order, (std::vector<int>{ 3, 2, 1, 0 }));
+}
+
+// 性能测试：大量批量任务排队时，随后提交的紧急任务的完成延迟（先进先出的线程池与优先级执行器对比）
+TEST(PriorityExecutorTest, UrgentLatencyBenchmark)
+{
+    using clock = std::chrono::steady_clock;
+    const int bulk = 2000, urgent = 20;
+    const std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    auto busy = [] {
+        const auto until = clock::now() + std::chrono::microseconds(50);
+        while (clock::now() < until) {}
+        };
+
+    auto average_ms = [](std::vector<std::future<clock::time_point>>& done, clock::time_point submitted) {
+        double total = 0;
+        for (auto& f : done) total += std::chrono::duration<double, std::milli>(f.get() - submitted).count();
+        return total / done.size();
+        };
+
+    double fifo_ms = 0;
+    {
+        ThreadPool pool(threads);
+        for (int i = 0; i < bulk; ++i) pool.submit(busy);
+        const auto submitted = clock::now();
+        std::vector<std::future<clock::time_point>> done;
+        for (int i = 0; i < urgent; ++i) done.push_back(pool.submit([] { return clock::now(); }));
+        fifo_ms = average_ms(done, submitted);
+    }
+
+    double priority_ms = 0;
+    {
+        PriorityExecutor executor(threads);
+        for (int i = 0; i < bulk; ++i) executor.post(0, busy);
+        const auto submitted = clock::now();
+        std::vector<std::future<clock::time_point>> done;
+        for (int i = 0; i < urgent; ++i) done.push_back(executor.submit(100, [] { return clock::now(); }));
+        priority_ms = average_ms(done, submitted);
+    }
+
+    std::cout << "\n" << bulk << " queued bulk tasks, " << threads << " threads - urgent task latency: FIFO pool "
+        << fifo_ms << "ms, priority executor " << priority_ms << "ms\n";
+}
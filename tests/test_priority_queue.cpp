@@ -0,0 +1,318 @@
+#include <thread_safe_queue/thread_safe_priority_queue.h>
+#include <thread_safe_queue/delay_queue.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <thread>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+
+// 测试1：批量入队后批量出队，结果按优先级从高到低排列
+TEST(PriorityQueueBulkTest, PushRangeThenPopTopK)
+{
+    ThreadSafePriorityQueue<int> queue;
+    std::vector<int> data = { 5, 1, 9, 3, 7, 2, 8, 6, 4, 0 };
+    queue.push_range(data.begin(), data.end());
+    EXPECT_EQ(queue.size(), data.size());
+
+    std::vector<int> top;
+    EXPECT_EQ(queue.pop_top_k(top, 4), 4u);
+    EXPECT_EQ(top, (std::vector<int>{ 9, 8, 7, 6 }));
+    EXPECT_EQ(queue.size(), 6u);
+
+    // k超过剩余元素时只取出剩余部分
+    std::vector<int> rest;
+    EXPECT_EQ(queue.pop_top_k(rest, 100), 6u);
+    EXPECT_EQ(rest, (std::vector<int>{ 5, 4, 3, 2, 1, 0 }));
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.pop_top_k(rest, 1), 0u);
+}
+
+// 测试2：小批量插入大堆（逐个上浮）与大批量插入小堆（整体堆化）结果一致
+TEST(PriorityQueueBulkTest, SmallAndLargeBatches)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 1'000'000);
+
+    ThreadSafePriorityQueue<int, std::vector<int>, std::greater<int>> queue;
+    std::vector<int> all;
+    for (int round = 0; round < 20; ++round)
+    {
+        // 交替插入大批量和小批量
+        std::vector<int> batch(round % 2 == 0 ? 1000 : 3);
+        for (auto& x : batch) x = dist(gen);
+        queue.push_range(batch.begin(), batch.end());
+        all.insert(all.end(), batch.begin(), batch.end());
+    }
+
+    std::sort(all.begin(), all.end());
+    std::vector<int> popped;
+    queue.pop_top_k(std::back_inserter(popped), all.size());
+    EXPECT_EQ(popped, all);
+}
+
+// 测试3：有界队列批量入队超过容量时分批等待，消费者取走后全部入队
+TEST(PriorityQueueBulkTest, BoundedPushRangeBlocksUntilSpace)
+{
+    ThreadSafePriorityQueue<int> queue(8);
+    std::vector<int> data(100);
+    for (int i = 0; i < 100; ++i) data[i] = i;
+
+    std::thread producer([&] {
+        queue.push_range(data.begin(), data.end());
+        });
+
+    std::vector<int> consumed;
+    while (consumed.size() < data.size())
+    {
+        if (queue.pop_top_k(consumed, 5) == 0)
+        {
+            std::this_thread::yield();
+        }
+        EXPECT_LE(queue.size(), 8u);
+    }
+    producer.join();
+
+    std::sort(consumed.begin(), consumed.end());
+    EXPECT_EQ(consumed, data);
+}
+
+// 测试4：支持移动迭代器，批量入队只移动不拷贝
+TEST(PriorityQueueBulkTest, MoveIterators)
+{
+    ThreadSafePriorityQueue<std::string> queue;
+    std::vector<std::string> data = { "b", "d", "a", "c" };
+    queue.push_range(std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
+
+    std::vector<std::string> top;
+    queue.pop_top_k(top, 2);
+    EXPECT_EQ(top, (std::vector<std::string>{ "d", "c" }));
+}
+
+// 测试5：d叉堆引擎与二叉堆弹出顺序一致（含重复元素）
+TEST(DaryHeapTest, MatchesBinaryHeapOrder)
+{
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(0, 500);
+    std::vector<int> data(5000);
+    for (auto& x : data) x = dist(gen);
+
+    ThreadSafePriorityQueue<int> binary;
+    ThreadSafePriorityQueue<int, DaryHeapContainer<int, 4>> quad;
+    ThreadSafePriorityQueue<int, DaryHeapContainer<int, 8>, std::greater<int>> oct;
+    for (int x : data)
+    {
+        binary.push(x);
+        quad.push(x);
+        oct.push(x);
+    }
+
+    std::vector<int> expected_desc(data);
+    std::sort(expected_desc.begin(), expected_desc.end(), std::greater<int>());
+    std::vector<int> expected_asc(data);
+    std::sort(expected_asc.begin(), expected_asc.end());
+
+    std::vector<int> a, b, c;
+    binary.pop_top_k(a, data.size());
+    for (int x; quad.try_pop(x);) b.push_back(x);
+    oct.pop_top_k(c, data.size());
+    EXPECT_EQ(a, expected_desc);
+    EXPECT_EQ(b, expected_desc);
+    EXPECT_EQ(c, expected_asc);
+}
+
+// 测试6：d叉堆的批量入队（逐个上浮与整体堆化两种路径）
+TEST(DaryHeapTest, PushRange)
+{
+    ThreadSafePriorityQueue<int, DaryHeapContainer<int, 4>> queue;
+    std::vector<int> big(1000), small = { 2000, -1, 500 };
+    for (int i = 0; i < 1000; ++i) big[i] = (i * 7919) % 1000;
+    queue.push_range(big.begin(), big.end());
+    queue.push_range(small.begin(), small.end());
+
+    std::vector<int> out;
+    EXPECT_EQ(queue.pop_top_k(out, 3), 3u);
+    EXPECT_EQ(out, (std::vector<int>{ 2000, 999, 998 }));
+    EXPECT_EQ(queue.size(), 1000u);
+}
+
+// 测试7：对齐分配器保证根的第一个子节点所在的兄弟组从缓存行起点开始
+TEST(DaryHeapTest, SiblingGroupsAreCacheLineAligned)
+{
+    DaryHeapContainer<int, 16> c(100);
+    auto addr = reinterpret_cast<std::uintptr_t>(c.data() + 1);
+    EXPECT_EQ(addr % kCacheLineSize, 0u);
+
+    DaryHeapContainer<double, 8> d(100);
+    addr = reinterpret_cast<std::uintptr_t>(d.data() + 1);
+    EXPECT_EQ(addr % kCacheLineSize, 0u);
+
+    // 对齐要求超过缓存行的类型：每个元素（包括下标0）都必须满足alignof(T)
+    struct alignas(128) Wide
+    {
+        int value = 0;
+        bool operator<(const Wide& other) const { return value < other.value; }
+    };
+    DaryHeapContainer<Wide, 4> w(10);
+    for (std::size_t i = 0; i < w.size(); ++i)
+    {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(w.data() + i) % alignof(Wide), 0u);
+    }
+}
+
+// 测试8：延迟队列使用d叉堆引擎
+TEST(DaryHeapTest, DelayQueueWithDaryHeap)
+{
+    DelayQueue<int, DaryHeapContainer<DelayElement<int>, 4>> dq;
+    dq.push(3, std::chrono::milliseconds(30));
+    dq.push(1, std::chrono::milliseconds(10));
+    dq.push(2, std::chrono::milliseconds(20));
+    EXPECT_EQ(dq.pop(), 1);
+    EXPECT_EQ(dq.pop(), 2);
+    EXPECT_EQ(dq.pop(), 3);
+    EXPECT_TRUE(dq.empty());
+}
+
+// 性能测试：1000万元素时不同堆引擎的单次弹出延迟
+template <typename Queue>
+double measure_pop_latency(const std::vector<int>& data, size_t pops, std::vector<int>& popped)
+{
+    Queue queue;
+    queue.push_range(data.begin(), data.end());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < pops; ++i)
+    {
+        int value = 0;
+        queue.try_pop(value);
+        popped.push_back(value);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now() - start
+    ).count();
+    return static_cast<double>(elapsed) / pops;
+}
+
+TEST(DaryHeapTest, PopLatencyComparison)
+{
+    const size_t n = 10'000'000;
+    const size_t pops = 1'000'000;
+    std::vector<int> data(n);
+    std::mt19937 gen(123);
+    for (auto& x : data) x = static_cast<int>(gen());
+
+    std::vector<int> binary_popped, quad_popped, oct_popped;
+    binary_popped.reserve(pops);
+    quad_popped.reserve(pops);
+    oct_popped.reserve(pops);
+
+    double binary_ns = measure_pop_latency<ThreadSafePriorityQueue<int>>(data, pops, binary_popped);
+    double quad_ns = measure_pop_latency<ThreadSafePriorityQueue<int, DaryHeapContainer<int, 4>>>(data, pops, quad_popped);
+    double oct_ns = measure_pop_latency<ThreadSafePriorityQueue<int, DaryHeapContainer<int, 8>>>(data, pops, oct_popped);
+
+    EXPECT_EQ(binary_popped, quad_popped);
+    EXPECT_EQ(binary_popped, oct_popped);
+
+    std::cout << "\nPop latency with " << n << " elements (" << pops << " pops):\n";
+    std::cout << "Binary heap: " << binary_ns << " ns/pop\n";
+    std::cout << "4-ary heap:  " << quad_ns << " ns/pop\n";
+    std::cout << "8-ary heap:  " << oct_ns << " ns/pop\n";
+}
+
+// 对照组：旧版实现中生产者和消费者共用一个条件变量的有界优先级队列
+class SingleCondVarPriorityQueue
+{
+private:
+    std::priority_queue<int> queue_;
+    std::mutex mutex_;
+    std::condition_variable cond_var_;
+    const size_t max_size_;
+
+public:
+    explicit SingleCondVarPriorityQueue(size_t max_size) : max_size_(max_size) {}
+
+    void push(int value)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_var_.wait(lock, [this] { return queue_.size() < max_size_; });
+        queue_.push(value);
+        cond_var_.notify_one();
+    }
+
+    void wait_and_pop(int& value)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_var_.wait(lock, [this] { return !queue_.empty(); });
+        value = queue_.top();
+        queue_.pop();
+        cond_var_.notify_one();
+    }
+};
+
+// 有界模式下多生产者多消费者的吞吐量，返回每秒处理的元素数；checksum用于校验没有丢失元素
+template <typename Queue>
+double bounded_contention_throughput(size_t capacity, int producers, int consumers, int items_per_producer,
+    long long& checksum)
+{
+    Queue queue(capacity);
+    std::atomic<long long> sum{ 0 };
+    const int total = producers * items_per_producer;
+    const int per_consumer = total / consumers;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&queue, items_per_producer] {
+            for (int i = 0; i < items_per_producer; ++i) queue.push(i);
+            });
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&queue, &sum, per_consumer] {
+            long long local = 0;
+            for (int i = 0; i < per_consumer; ++i)
+            {
+                int value = 0;
+                queue.wait_and_pop(value);
+                local += value;
+            }
+            sum += local;
+            });
+    }
+    for (auto& t : threads) t.join();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start
+    ).count();
+
+    checksum = sum.load();
+    return total / (elapsed / 1e6);
+}
+
+// 测试9：有界模式高竞争下所有元素都被消费（无停顿），并与单条件变量版本对比吞吐量
+TEST(PriorityQueueContentionTest, BoundedProducerConsumerThroughput)
+{
+    const int producers = 4, consumers = 4, items = 50'000;
+    const long long expected = static_cast<long long>(producers) * items * (items - 1) / 2;
+
+    long long split_sum = 0, single_sum = 0;
+    double split = bounded_contention_throughput<ThreadSafePriorityQueue<int>>(
+        16, producers, consumers, items, split_sum);
+    double single = bounded_contention_throughput<SingleCondVarPriorityQueue>(
+        16, producers, consumers, items, single_sum);
+
+    EXPECT_EQ(split_sum, expected);
+    EXPECT_EQ(single_sum, expected);
+
+    std::cout << "\nBounded contention (" << producers << "P/" << consumers << "C, capacity 16):\n";
+    std::cout << "Split condition variables:  " << split << " items/s\n";
+    std::cout << "Single condition variable:  " << single << " items/s\n";
+    std::cout << "Speedup: " << split / single << "x\n";
+}
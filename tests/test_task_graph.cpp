@@ -0,0 +1,169 @@
+#include <parallel_algorithm/task_graph.h>
+#include <parallel_algorithm/merge_sort.h>
+#include <parallel_algorithm/prefix_sum.h>
+#include <parallel_algorithm/accumulate.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <random>
+#include <functional>
+#include <stdexcept>
+#include <iostream>
+
+// 测试1：每个节点都在全部前驱完成之后执行，同一个图可以重复执行
+TEST(TaskGraphTest, DependenciesAreRespected)
+{
+    ThreadPool pool(3);
+    TaskGraph graph;
+    const int layers = 6, width = 8;
+    std::atomic<int> clock{ 0 };
+    std::vector<int> finished_at(layers * width, -1), started_at(layers * width, -1);
+    std::vector<TaskGraph::NodeId> previous;
+    for (int layer = 0; layer < layers; ++layer)
+    {
+        std::vector<TaskGraph::NodeId> current;
+        for (int i = 0; i < width; ++i)
+        {
+            const int index = layer * width + i;
+            auto id = graph.add_node("n" + std::to_string(index), [&, index] {
+                started_at[index] = clock.fetch_add(1);
+                finished_at[index] = clock.fetch_add(1);
+                });
+            // 依赖上一层中相邻的两个节点
+            if (!previous.empty())
+            {
+                graph.add_dependency(previous[i], id);
+                graph.add_dependency(previous[(i + 1) % width], id);
+            }
+            current.push_back(id);
+        }
+        previous = current;
+    }
+
+    for (int round = 0; round < 3; ++round)
+    {
+        clock = 0;
+        graph.run(pool);
+        for (int layer = 1; layer < layers; ++layer)
+        {
+            for (int i = 0; i < width; ++i)
+            {
+                const int index = layer * width + i;
+                EXPECT_GT(started_at[index], finished_at[(layer - 1) * width + i]);
+                EXPECT_GT(started_at[index], finished_at[(layer - 1) * width + (i + 1) % width]);
+            }
+        }
+        EXPECT_EQ(clock.load(), 2 * layers * width);
+    }
+
+    // 没有工作线程时在调用线程按依赖顺序执行
+    ThreadPool inline_pool(0);
+    clock = 0;
+    graph.run(inline_pool);
+    EXPECT_EQ(clock.load(), 2 * layers * width);
+}
+
+// 测试2：有环时抛出logic_error；节点抛出异常后其后继不再执行，run重新抛出该异常，下一次run正常执行
+TEST(TaskGraphTest, CyclesAndErrors)
+{
+    ThreadPool pool(2);
+    {
+        TaskGraph graph;
+        auto a = graph.add_node("a", [] {});
+        auto b = graph.add_node("b", [] {}, { a });
+        graph.add_dependency(b, a);
+        EXPECT_THROW(graph.run(pool), std::logic_error);
+        EXPECT_THROW(graph.add_dependency(a, 5), std::out_of_range);
+    }
+
+    TaskGraph graph;
+    bool fail = true;
+    std::atomic<int> after_failure{ 0 };
+    auto source = graph.add_node("source", [&] { if (fail) throw std::runtime_error("node failed"); });
+    auto middle = graph.add_node("middle", [&] { after_failure++; }, { source });
+    graph.add_node("sink", [&] { after_failure++; }, { middle });
+    EXPECT_THROW(graph.run(pool), std::runtime_error);
+    EXPECT_EQ(after_failure.load(), 0);
+
+    fail = false;
+    graph.run(pool);
+    EXPECT_EQ(after_failure.load(), 2);
+}
+
+// 测试3：关键路径为实测耗时之和最大的依赖链
+TEST(TaskGraphTest, CriticalPathTiming)
+{
+    using namespace std::chrono_literals;
+    ThreadPool pool(2);
+    TaskGraph graph;
+    auto load = graph.add_node("load", [] { std::this_thread::sleep_for(20ms); });
+    auto slow = graph.add_node("slow", [] { std::this_thread::sleep_for(40ms); }, { load });
+    auto fast = graph.add_node("fast", [] { std::this_thread::sleep_for(5ms); }, { load });
+    auto merge = graph.add_node("merge", [] { std::this_thread::sleep_for(1ms); }, { slow, fast });
+    graph.run(pool);
+
+    EXPECT_EQ(graph.critical_path(), (std::vector<TaskGraph::NodeId>{ load, slow, merge }));
+    EXPECT_TRUE(graph.timing(slow).critical);
+    EXPECT_FALSE(graph.timing(fast).critical);
+    EXPECT_GE(graph.timing(slow).duration(), 40ms);
+    EXPECT_GE(graph.timing(slow).start, graph.timing(load).finish);
+    EXPECT_GE(graph.timing(merge).start, graph.timing(slow).finish);
+    EXPECT_EQ(graph.timing(merge).path,
+        graph.timing(load).duration() + graph.timing(slow).duration() + graph.timing(merge).duration());
+    EXPECT_EQ(graph.critical_path_time(), graph.timing(merge).path);
+    EXPECT_GE(graph.last_run_time(), 61ms);
+
+    std::cout << "\n";
+    for (TaskGraph::NodeId id = 0; id < graph.size(); ++id)
+    {
+        const auto& t = graph.timing(id);
+        std::cout << graph.name(id) << ": start " << std::chrono::duration<double, std::milli>(t.start).count()
+            << "ms, duration " << std::chrono::duration<double, std::milli>(t.duration()).count()
+            << "ms" << (t.critical ? " (critical)" : "") << "\n";
+    }
+}
+
+// 性能测试：多组数据的排序->前缀和->求和流水线，逐阶段全局同步与任务图（各组的阶段互相重叠）对比
+TEST(TaskGraphTest, PipelineBenchmark)
+{
+    const int groups = 8;
+    const size_t n = 200000;
+    std::mt19937 rng(7);
+    std::vector<std::vector<int>> inputs(groups, std::vector<int>(n));
+    for (auto& input : inputs)
+    {
+        for (auto& x : input) x = static_cast<int>(rng() % 100);
+    }
+    ThreadPool& pool = default_thread_pool();
+
+    std::vector<std::vector<int>> data;
+    std::vector<long long> barrier_sums(groups), graph_sums(groups);
+
+    data = inputs;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto& d : data) parallel_merge_sort(pool, d);
+    for (auto& d : data) d = parallel_prefix(pool, d, std::plus<int>(), 0);
+    for (int g = 0; g < groups; ++g) barrier_sums[g] = parallel_accumulate(pool, data[g].begin(), data[g].end(), 0LL);
+    const double barrier_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    TaskGraph graph;
+    for (int g = 0; g < groups; ++g)
+    {
+        auto sort = graph.add_node("sort", [&, g] { parallel_merge_sort(pool, data[g]); });
+        auto scan = graph.add_node("scan", [&, g] { data[g] = parallel_prefix(pool, data[g], std::plus<int>(), 0); }, { sort });
+        graph.add_node("sum", [&, g] { graph_sums[g] = parallel_accumulate(pool, data[g].begin(), data[g].end(), 0LL); }, { scan });
+    }
+    data = inputs;
+    graph.run(pool);  // 第一次执行包含图检查
+    data = inputs;
+    start = std::chrono::high_resolution_clock::now();
+    graph.run(pool);
+    const double graph_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    EXPECT_EQ(barrier_sums, graph_sums);
+    std::cout << "\nbarrier stages: " << barrier_ms << "ms, task graph: " << graph_ms
+        << "ms, critical path: " << std::chrono::duration<double, std::milli>(graph.critical_path_time()).count() << "ms\n";
+}
@@ -0,0 +1,161 @@
+#include <parallel_algorithm/thread_affinity.h>
+#include <parallel_algorithm/thread_pool.h>
+#include <parallel_algorithm/execution_policy.h>
+#include <parallel_algorithm/accumulate.h>
+#include <parallel_algorithm/for_each.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <iostream>
+
+// 两个节点、每个节点4个CPU的虚拟拓扑
+cpu_topology two_socket_topology()
+{
+    cpu_topology topology;
+    topology.nodes = { { 0, 1, 2, 3 }, { 4, 5, 6, 7 } };
+    return topology;
+}
+
+// 测试1：解析内核CPU列表格式，当前机器的拓扑覆盖全部可用CPU且没有重复
+TEST(ThreadAffinityTest, TopologyDetection)
+{
+    EXPECT_EQ(cpu_topology::parse_cpu_list("0-3,8-9,12\n"), (std::vector<int>{ 0, 1, 2, 3, 8, 9, 12 }));
+    EXPECT_TRUE(cpu_topology::parse_cpu_list("").empty());
+
+    const cpu_topology& topology = cpu_topology::current();
+    ASSERT_FALSE(topology.nodes.empty());
+    std::set<int> cpus;
+    for (const auto& node : topology.nodes)
+    {
+        EXPECT_FALSE(node.empty());
+        cpus.insert(node.begin(), node.end());
+    }
+    EXPECT_EQ(cpus.size(), topology.cpu_count());
+}
+
+// 测试2：三种放置策略在双路拓扑上的分配结果
+TEST(ThreadAffinityTest, PlacementPolicies)
+{
+    const cpu_topology topology = two_socket_topology();
+    using cpus = std::vector<std::vector<int>>;
+
+    EXPECT_EQ(worker_placement(topology, affinity_policy::none, 3), cpus(3));
+    EXPECT_EQ(worker_placement(topology, affinity_policy::compact, 5),
+        (cpus{ { 0 }, { 1 }, { 2 }, { 3 }, { 4 } }));
+    EXPECT_EQ(worker_placement(topology, affinity_policy::scatter, 5),
+        (cpus{ { 0 }, { 4 }, { 1 }, { 5 }, { 2 } }));
+    EXPECT_EQ(worker_placement(topology, affinity_policy::numa_node, 3),
+        (cpus{ { 0, 1, 2, 3 }, { 0, 1, 2, 3 }, { 4, 5, 6, 7 } }));
+    // 工作线程多于CPU时循环使用
+    EXPECT_EQ(worker_placement(topology, affinity_policy::compact, 10)[9], std::vector<int>{ 1 });
+}
+
+// 测试3：post_to的任务只在指定的工作线程上执行，绑核后工作线程运行在分配的CPU上
+TEST(ThreadAffinityTest, PinnedWorkersAndTargetedTasks)
+{
+    ThreadPool pool(3, affinity_policy::compact);
+    EXPECT_FALSE(pool.current_worker().has_value());
+
+    std::vector<std::atomic<int>> wrong(3);
+    TaskGroup group(pool);
+    for (int round = 0; round < 50; ++round)
+    {
+        for (size_t worker = 0; worker < 3; ++worker)
+        {
+            group.run_on(worker, [&, worker] {
+                if (pool.current_worker() != worker) wrong[worker].fetch_add(1);
+#if defined(__linux__)
+                const auto& assigned = pool.worker_cpus(worker);
+                const int cpu = sched_getcpu();
+                if (std::find(assigned.begin(), assigned.end(), cpu) == assigned.end()) wrong[worker].fetch_add(1);
+#endif
+                });
+        }
+    }
+    group.wait();
+    for (auto& count : wrong)
+    {
+        EXPECT_EQ(count.load(), 0);
+    }
+}
+
+// 测试4：numa_local时同一长度、同一策略的多次调用把每块交给同一工作线程，调用线程不处理数据块
+TEST(ThreadAffinityTest, NumaLocalBlocksAreStable)
+{
+    ThreadPool pool(3, affinity_policy::numa_node);
+    const execution_policy policy = execution::par.on(pool).numa();
+    std::vector<int> data(4000, 1);
+    std::vector<int> first_owner(data.size(), -1), second_owner(data.size(), -1);
+
+    auto record = [&](std::vector<int>& owner) {
+        parallel_for_each_s(policy, data.begin(), data.end(), [&](int& x) {
+            auto worker = pool.current_worker();
+            owner[&x - data.data()] = worker ? static_cast<int>(*worker) : -2;
+            });
+        };
+    record(first_owner);
+    record(second_owner);
+    EXPECT_EQ(first_owner, second_owner);
+    EXPECT_EQ(std::set<int>(first_owner.begin(), first_owner.end()), (std::set<int>{ 0, 1, 2 }));
+
+    EXPECT_EQ(parallel_accumulate(policy, data.begin(), data.end(), 0), 4000);
+
+    // 没有工作线程时退化为在调用线程执行
+    ThreadPool inline_pool(0);
+    EXPECT_EQ(parallel_accumulate(execution::par.on(inline_pool).numa(), data.begin(), data.end(), 0), 4000);
+}
+
+// 性能测试：不同放置策略下并行求和的内存带宽；"caller touch"由调用线程初始化数据（内存页全部落在调用线程所在节点），
+// "local touch"用同一numa_local策略并行初始化，每块数据在处理它的工作线程所在节点上分配
+double sum_bandwidth_gbps(const execution_policy& policy, const double* data, size_t n, double& checksum)
+{
+    const int repeats = 5;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r)
+    {
+        checksum += parallel_accumulate(policy, data, data + n, 0.0);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    return static_cast<double>(n * sizeof(double)) * repeats / seconds / 1e9;
+}
+
+TEST(ThreadAffinityTest, BandwidthBenchmark)
+{
+    const size_t n = size_t(1) << 24;  // 128MB
+    // numa_local时调用线程不处理数据块，工作线程数取硬件线程数
+    const size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    const cpu_topology& topology = cpu_topology::current();
+    std::cout << "\n" << topology.nodes.size() << " NUMA node(s), " << topology.cpu_count() << " CPUs, "
+        << workers << " workers, " << n * sizeof(double) / (1 << 20) << "MB per pass:\n";
+
+    const std::pair<affinity_policy, const char*> placements[] = {
+        { affinity_policy::none, "none" },
+        { affinity_policy::compact, "compact" },
+        { affinity_policy::scatter, "scatter" },
+        { affinity_policy::numa_node, "numa_node" },
+    };
+    double checksum = 0;
+    for (const auto& [affinity, name] : placements)
+    {
+        ThreadPool pool(workers, affinity);
+        const execution_policy policy = execution::par.on(pool).numa();
+
+        // 未初始化的数组，首次写入时才分配物理页
+        std::unique_ptr<double[]> caller_touched(new double[n]);
+        std::fill(caller_touched.get(), caller_touched.get() + n, 1.0);
+        const double caller_gbps = sum_bandwidth_gbps(policy, caller_touched.get(), n, checksum);
+        caller_touched.reset();
+
+        std::unique_ptr<double[]> local_touched(new double[n]);
+        parallel_for_each_s(policy, local_touched.get(), local_touched.get() + n, [](double& x) { x = 1.0; });
+        const double local_gbps = sum_bandwidth_gbps(policy, local_touched.get(), n, checksum);
+
+        std::cout << name << " - caller touch: " << caller_gbps << " GB/s, local touch: " << local_gbps << " GB/s\n";
+    }
+    EXPECT_EQ(checksum, 2.0 * 4 * 5 * static_cast<double>(n));
+}
@@ -0,0 +1,543 @@
+#include <parallel_algorithm/thread_pool.h>
+#include <parallel_algorithm/accumulate.h>
+#include <parallel_algorithm/for_each.h>
+#include <parallel_algorithm/prefix_sum.h>
+#include <parallel_algorithm/merge_sort.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <list>
+#include <numeric>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <iostream>
+
+// 测试1：submit通过future返回结果与异常
+TEST(ThreadPoolTest, SubmitReturnsResultAndException)
+{
+    ThreadPool pool(2);
+    auto value = pool.submit([] { return 42; });
+    auto error = pool.submit([]() -> int { throw std::logic_error("boom"); });
+    EXPECT_EQ(value.get(), 42);
+    EXPECT_THROW(error.get(), std::logic_error);
+}
+
+// 测试2：没有工作线程的线程池在提交线程中直接执行任务
+TEST(ThreadPoolTest, ZeroWorkersRunsInline)
+{
+    ThreadPool pool(0);
+    EXPECT_EQ(pool.concurrency(), 1u);
+    const auto caller = std::this_thread::get_id();
+    std::thread::id runner;
+    TaskGroup group(pool);
+    group.run([&] { runner = std::this_thread::get_id(); });
+    group.wait();
+    EXPECT_EQ(runner, caller);
+}
+
+// 测试3：嵌套任务组在小线程池上不会死锁（等待者帮忙执行队列中的任务）
+long long fib(ThreadPool& pool, int n)
+{
+    if (n < 12)
+    {
+        return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    }
+    long long left = 0;
+    TaskGroup group(pool);
+    group.run([&] { left = fib(pool, n - 1); });
+    const long long right = fib(pool, n - 2);
+    group.wait();
+    return left + right;
+}
+
+TEST(ThreadPoolTest, NestedGroupsDoNotDeadlock)
+{
+    ThreadPool pool(2);
+    EXPECT_EQ(fib(pool, 24), 46368);
+}
+
+// 测试4：任务组重新抛出第一个异常，其余任务照常完成
+TEST(ThreadPoolTest, TaskGroupPropagatesException)
+{
+    ThreadPool pool(3);
+    std::atomic<int> finished{ 0 };
+    TaskGroup group(pool);
+    for (int i = 0; i < 16; ++i)
+    {
+        group.run([&, i] {
+            if (i == 5) throw std::runtime_error("task 5");
+            finished.fetch_add(1);
+            });
+    }
+    EXPECT_THROW(group.wait(), std::runtime_error);
+    EXPECT_EQ(finished.load(), 15);
+}
+
+// 测试5：析构前执行完队列中剩余的任务
+TEST(ThreadPoolTest, DestructorDrainsQueuedTasks)
+{
+    std::atomic<int> done{ 0 };
+    {
+        ThreadPool pool(1);
+        for (int i = 0; i < 100; ++i)
+        {
+            pool.post([&] { done.fetch_add(1); });
+        }
+    }
+    EXPECT_EQ(done.load(), 100);
+}
+
+// 测试6：各并行算法的执行器重载在指定线程池上结果正确
+TEST(ThreadPoolTest, AlgorithmsOnExplicitExecutor)
+{
+    ThreadPool pool(3);
+    std::vector<int> data(100000);
+    std::iota(data.begin(), data.end(), 0);
+
+    const long long expected_sum = std::accumulate(data.begin(), data.end(), 0LL);
+    EXPECT_EQ(parallel_accumulate(pool, data.begin(), data.end(), 0LL), expected_sum);
+    EXPECT_EQ(parallel_accumulate(pool, data.begin(), data.end(), 0LL, std::plus<long long>(), 2), expected_sum);
+
+    std::atomic<long long> visited{ 0 };
+    parallel_for_each_s(pool, data.begin(), data.end(), [&](int x) { visited += x; });
+    EXPECT_EQ(visited.load(), expected_sum);
+
+    std::list<int> items(data.begin(), data.end());
+    parallel_for_each_d(pool, items.begin(), items.end(), [](int& x) { x *= 2; });
+    EXPECT_EQ(std::accumulate(items.begin(), items.end(), 0LL), expected_sum * 2);
+
+    EXPECT_THROW(parallel_for_each_d(pool, data.begin(), data.end(), [](int x) {
+        if (x == 777) throw std::invalid_argument("bad element");
+        }), std::runtime_error);
+
+    std::vector<long long> values(data.begin(), data.end());
+    auto op = [](long long a, long long b) { return a + b; };
+    EXPECT_EQ(parallel_prefix(pool, values, op, 0LL), sequential_prefix(values, op, 0LL));
+
+    std::vector<int> shuffled = data;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(3));
+    parallel_merge_sort(pool, shuffled, 1000);
+    EXPECT_EQ(shuffled, data);
+}
+
+// 测试7：parallel_invoke并行执行全部函数并重新抛出异常
+TEST(ForkJoinTest, ParallelInvoke)
+{
+    ThreadPool pool(3);
+    int a = 0, b = 0, c = 0;
+    parallel_invoke(pool, [&] { a = 1; }, [&] { b = 2; }, [&] { c = 3; });
+    EXPECT_EQ(a + b + c, 6);
+
+    EXPECT_THROW(parallel_invoke(pool,
+        [] {},
+        [] { throw std::out_of_range("right"); }), std::out_of_range);
+
+    int only = 0;
+    parallel_invoke([&] { only = 7; });  // 默认线程池，单个函数直接执行
+    EXPECT_EQ(only, 7);
+}
+
+// 测试8：递归任意拆分的细粒度任务（每个叶子只有几十个元素），结果正确且不死锁
+long long recursive_sum(ThreadPool& pool, const int* first, const int* last)
+{
+    const std::ptrdiff_t n = last - first;
+    if (n <= 64)
+    {
+        return std::accumulate(first, last, 0LL);
+    }
+    long long left = 0, right = 0;
+    const int* mid = first + n / 2;
+    parallel_invoke(pool,
+        [&] { left = recursive_sum(pool, first, mid); },
+        [&] { right = recursive_sum(pool, mid, last); });
+    return left + right;
+}
+
+TEST(ForkJoinTest, FineGrainedRecursion)
+{
+    ThreadPool pool(4);
+    std::vector<int> data(1 << 20);
+    std::iota(data.begin(), data.end(), 0);
+    const long long expected = std::accumulate(data.begin(), data.end(), 0LL);
+    for (int round = 0; round < 5; ++round)
+    {
+        ASSERT_EQ(recursive_sum(pool, data.data(), data.data() + data.size()), expected);
+    }
+}
+
+// 测试9：多个外部线程同时提交任务组，任务内部再嵌套拆分
+TEST(ForkJoinTest, ConcurrentExternalSubmitters)
+{
+    ThreadPool pool(3);
+    std::vector<int> data(1 << 16, 1);
+    std::atomic<long long> total{ 0 };
+    std::vector<std::thread> submitters;
+    for (int t = 0; t < 4; ++t)
+    {
+        submitters.emplace_back([&] {
+            for (int i = 0; i < 20; ++i)
+            {
+                total += recursive_sum(pool, data.data(), data.data() + data.size());
+            }
+            });
+    }
+    for (auto& t : submitters) t.join();
+    EXPECT_EQ(total.load(), 4LL * 20 * static_cast<long long>(data.size()));
+}
+
+// 等待条件成立，最多等待timeout
+template <typename Pred>
+bool eventually(Pred pred, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred())
+    {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// 测试10：动态线程池在任务积压时增加线程直到上限，空闲超过keep_alive后退回下限，之后仍能正常执行任务
+TEST(DynamicPoolTest, GrowsUnderBacklogAndRetiresWhenIdle)
+{
+    using namespace std::chrono_literals;
+    ThreadPool::Sizing sizing;
+    sizing.min_threads = 1;
+    sizing.max_threads = 4;
+    sizing.backlog_per_worker = 1;
+    sizing.keep_alive = 50ms;
+    ThreadPool pool(sizing);
+    EXPECT_EQ(pool.size(), 4u);
+    EXPECT_EQ(pool.active_workers(), 1u);
+
+    std::atomic<bool> release{ false };
+    std::atomic<int> running{ 0 };
+    std::vector<std::future<void>> done;
+    for (int i = 0; i < 8; ++i)
+    {
+        done.push_back(pool.submit([&] {
+            running++;
+            while (!release) std::this_thread::sleep_for(1ms);
+            }));
+    }
+    // 阻塞的任务占满已有线程，积压的任务促使线程数增长到上限
+    EXPECT_TRUE(eventually([&] { return running.load() == 4; }));
+    EXPECT_EQ(pool.active_workers(), 4u);
+    EXPECT_EQ(pool.spawned_workers(), 4u);
+    release = true;
+    for (auto& f : done) f.get();
+
+    EXPECT_TRUE(eventually([&] { return pool.active_workers() == 1; }));
+    EXPECT_EQ(pool.retired_workers(), 3u);
+
+    std::vector<int> data(100000, 1);
+    EXPECT_EQ(parallel_accumulate(pool, data.begin(), data.end(), 0), 100000);
+    EXPECT_THROW(ThreadPool(ThreadPool::Sizing{ 3, 2 }), std::invalid_argument);
+}
+
+// 测试11：下限为0时没有常驻线程，提交任务或向已退出的工作线程post_to时重新启动线程
+TEST(DynamicPoolTest, RestartsFromZeroThreads)
+{
+    using namespace std::chrono_literals;
+    ThreadPool::Sizing sizing;
+    sizing.min_threads = 0;
+    sizing.max_threads = 3;
+    sizing.keep_alive = 20ms;
+    ThreadPool pool(sizing);
+    EXPECT_EQ(pool.active_workers(), 0u);
+
+    for (int round = 0; round < 3; ++round)
+    {
+        EXPECT_EQ(pool.submit([] { return 7; }).get(), 7);
+        std::promise<std::optional<std::size_t>> where;
+        auto worker = where.get_future();
+        pool.post_to(2, [&] { where.set_value(pool.current_worker()); });
+        EXPECT_EQ(worker.get(), std::optional<std::size_t>(2));
+        EXPECT_TRUE(eventually([&] { return pool.active_workers() == 0; }));
+    }
+    EXPECT_EQ(pool.spawned_workers(), pool.retired_workers());
+    EXPECT_GE(pool.spawned_workers(), 6u);
+}
+
+// 测试12：达到min_threads后无法退出的空闲线程重新开始计时，不会因等待期限已过而空转
+TEST(DynamicPoolTest, IdleWorkersAtFloorDoNotSpin)
+{
+    using namespace std::chrono_literals;
+    ThreadPool::Sizing sizing;
+    sizing.min_threads = 2;
+    sizing.max_threads = 4;
+    sizing.keep_alive = 20ms;
+    ThreadPool pool(sizing);
+    EXPECT_EQ(pool.submit([] { return 1; }).get(), 1);
+
+    std::this_thread::sleep_for(200ms);
+    EXPECT_EQ(pool.retired_workers(), 0u);
+    EXPECT_EQ(pool.active_workers(), 2u);
+    // 每个线程每20ms超时一次，约20次；空转时为成千上万次
+    EXPECT_LE(pool.idle_timeouts(), 60u);
+}
+
+// 测试13：唯一的工作线程被阻塞任务占住、之后不再提交任务时，排队超过max_latency的任务也会促使线程数增长
+TEST(DynamicPoolTest, GrowsWhenQueuedTaskWaitsTooLong)
+{
+    using namespace std::chrono_literals;
+    ThreadPool::Sizing sizing;
+    sizing.min_threads = 1;
+    sizing.max_threads = 4;
+    sizing.backlog_per_worker = 8;
+    sizing.max_latency = 1ms;
+    ThreadPool pool(sizing);
+
+    std::atomic<bool> release{ false };
+    std::atomic<bool> blocking{ false };
+    auto blocker = pool.submit([&] {
+        blocking = true;
+        while (!release) std::this_thread::sleep_for(1ms);
+        });
+    ASSERT_TRUE(eventually([&] { return blocking.load(); }));
+
+    // 排队任务数远低于backlog阈值，只能由延迟检查触发增长
+    auto queued = pool.submit([] { return 3; });
+    const auto status = queued.wait_for(1s);
+    const std::size_t active = pool.active_workers();
+    release = true;  // 先放行阻塞任务，断言失败时也不会卡住
+    EXPECT_EQ(status, std::future_status::ready);
+    EXPECT_GE(active, 2u);
+    EXPECT_EQ(queued.get(), 3);
+    blocker.get();
+}
+
+// 测试14：lazy_start的线程池在第一次提交任务时才启动线程；warm_up启动全部工作线程（包括动态线程池的上限）并在每个线程上执行一次
+TEST(PoolStartupTest, LazyStartAndWarmUp)
+{
+    ThreadPool::Sizing sizing;
+    sizing.min_threads = 3;
+    sizing.max_threads = 3;
+    sizing.lazy_start = true;
+    ThreadPool lazy(sizing);
+    EXPECT_EQ(lazy.active_workers(), 0u);
+    EXPECT_EQ(lazy.submit([] { return 5; }).get(), 5);
+    EXPECT_EQ(lazy.active_workers(), 3u);
+    EXPECT_EQ(lazy.spawned_workers(), 3u);
+
+    ThreadPool::Sizing dynamic_sizing;
+    dynamic_sizing.min_threads = 0;
+    dynamic_sizing.max_threads = 4;
+    dynamic_sizing.keep_alive = std::chrono::milliseconds(20);
+    ThreadPool dynamic(dynamic_sizing);
+    EXPECT_EQ(dynamic.active_workers(), 0u);
+    ThreadPool::WarmUp options;
+    options.stack_bytes = 256 * 1024;
+    options.scratch_bytes = 4 << 20;
+    dynamic.warm_up(options);
+    EXPECT_EQ(dynamic.spawned_workers(), 4u);
+    // 预热后空闲的线程照常退出
+    EXPECT_TRUE(eventually([&] { return dynamic.active_workers() == 0; }));
+
+    ThreadPool pinned(2, affinity_policy::compact);
+    pinned.warm_up();
+    std::vector<int> data(100000, 1);
+    EXPECT_EQ(parallel_accumulate(pinned, data.begin(), data.end(), 0), 100000);
+
+    ThreadPool inline_pool(0);
+    inline_pool.warm_up();
+    EXPECT_EQ(inline_pool.submit([] { return 1; }).get(), 1);
+
+    // 在工作线程中调用warm_up（包括两个工作线程同时调用）不会死锁
+    ThreadPool nested(3);
+    std::promise<void> both_started;
+    std::atomic<int> started{ 0 };
+    auto gate = both_started.get_future().share();
+    std::vector<std::future<void>> warmed;
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        auto done = std::make_shared<std::promise<void>>();
+        warmed.push_back(done->get_future());
+        nested.post_to(i, [&nested, &started, &both_started, gate, done] {
+            if (++started == 2) both_started.set_value();
+            gate.wait();
+            nested.warm_up();
+            done->set_value();
+            });
+    }
+    for (auto& f : warmed)
+    {
+        ASSERT_EQ(f.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    }
+}
+
+// 性能测试：细粒度递归拆分在工作窃取线程池上的耗时（与串行求和对比）
+TEST(ForkJoinTest, RecursiveSplitBenchmark)
+{
+    ThreadPool& pool = default_thread_pool();
+    std::vector<int> data(1 << 24, 1);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const long long serial = std::accumulate(data.begin(), data.end(), 0LL);
+    const auto serial_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    const long long parallel = recursive_sum(pool, data.data(), data.data() + data.size());
+    const auto parallel_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    EXPECT_EQ(serial, parallel);
+    std::cout << "\nRecursive split down to 64 elements (" << data.size() / 64 << " leaf tasks, "
+        << pool.size() << " pool workers):\n";
+    std::cout << "Serial: " << serial_ms << "ms, fork-join: " << parallel_ms << "ms\n";
+}
+
+// 性能测试：每次调用创建线程与复用线程池的调用开销（1K~1M元素的并行求和）
+long long spawn_per_call_accumulate(const std::vector<long long>& data, size_t num_threads)
+{
+    std::vector<long long> partial(num_threads);
+    std::vector<std::thread> threads;
+    const size_t block = data.size() / num_threads;
+    for (size_t i = 0; i < num_threads; ++i)
+    {
+        auto begin = data.begin() + i * block;
+        auto end = i == num_threads - 1 ? data.end() : begin + block;
+        threads.emplace_back([&partial, i, begin, end] { partial[i] = std::accumulate(begin, end, 0LL); });
+    }
+    for (auto& t : threads) t.join();
+    return std::accumulate(partial.begin(), partial.end(), 0LL);
+}
+
+TEST(ThreadPoolTest, CallOverheadBenchmark)
+{
+    ThreadPool& pool = default_thread_pool();
+    const size_t num_threads = pool.concurrency();
+    std::cout << "\nParallel accumulate, " << num_threads << " tasks per call (" << pool.size() << " pool workers):\n";
+    for (size_t n : { 1'000, 10'000, 100'000, 1'000'000 })
+    {
+        std::vector<long long> data(n, 1);
+        const int calls = static_cast<int>(std::max<size_t>(20, 20'000'000 / n / 10));
+
+        auto start = std::chrono::high_resolution_clock::now();
+        long long spawn_total = 0;
+        for (int i = 0; i < calls; ++i) spawn_total += spawn_per_call_accumulate(data, num_threads);
+        const double spawn_us = std::chrono::duration<double, std::micro>(
+            std::chrono::high_resolution_clock::now() - start).count() / calls;
+
+        start = std::chrono::high_resolution_clock::now();
+        long long pool_total = 0;
+        for (int i = 0; i < calls; ++i) pool_total += parallel_accumulate(pool, data.begin(), data.end(), 0LL);
+        const double pool_us = std::chrono::duration<double, std::micro>(
+            std::chrono::high_resolution_clock::now() - start).count() / calls;
+
+        EXPECT_EQ(spawn_total, pool_total);
+        std::cout << n << " elements - spawn threads: " << spawn_us << "us/call, thread pool: "
+            << pool_us << "us/call\n";
+    }
+}
+
+// 性能测试：突发负载（每批64个约1ms的阻塞任务，批次之间空闲）下固定大小与动态线程池的每批耗时与线程启动、退出次数
+TEST(DynamicPoolTest, BurstyLoadBenchmark)
+{
+    using namespace std::chrono_literals;
+    auto run_bursts = [](ThreadPool& pool) {
+        double total_ms = 0;
+        const int bursts = 5;
+        for (int b = 0; b < bursts; ++b)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            TaskGroup group(pool);
+            for (int i = 0; i < 64; ++i)
+            {
+                group.run([] { std::this_thread::sleep_for(1ms); });
+            }
+            group.wait();
+            total_ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            std::this_thread::sleep_for(60ms);  // 空闲时间超过keep_alive
+        }
+        return total_ms / bursts;
+        };
+
+    ThreadPool fixed(8);
+    const double fixed_ms = run_bursts(fixed);
+
+    ThreadPool::Sizing sizing;
+    sizing.min_threads = 1;
+    sizing.max_threads = 8;
+    sizing.keep_alive = 30ms;
+    ThreadPool dynamic(sizing);
+    const double dynamic_ms = run_bursts(dynamic);
+
+    std::cout << "\nfixed 8 workers: " << fixed_ms << "ms/burst; dynamic 1~8 workers: " << dynamic_ms
+        << "ms/burst, " << dynamic.spawned_workers() << " spawned, " << dynamic.retired_workers()
+        << " retired, " << dynamic.active_workers() << " active when idle\n";
+    EXPECT_LE(dynamic.active_workers(), 8u);
+}
+
+// 性能测试：第一次调用并行算法到得到结果的耗时。短命令行进程每次都从新建线程池开始（立即启动/延迟启动线程，
+// 与不使用线程池的串行排序对比）；常驻服务在启动阶段创建线程池并warm_up，请求到来时只付出计算本身的时间
+TEST(PoolStartupTest, TimeToFirstResultBenchmark)
+{
+    using clock = std::chrono::high_resolution_clock;
+    auto ms_since = [](clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        };
+    const std::size_t threads = 4;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 1000000);
+    std::vector<int> input(200000);
+    for (auto& x : input) x = dist(gen);
+    std::vector<int> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<int> data = input;
+    auto start = clock::now();
+    std::sort(data.begin(), data.end());
+    const double sequential_ms = ms_since(start);
+
+    data = input;
+    start = clock::now();
+    double eager_ms = 0;
+    {
+        ThreadPool pool(threads);
+        parallel_merge_sort(pool, data);
+        eager_ms = ms_since(start);
+    }
+    EXPECT_EQ(data, expected);
+
+    ThreadPool::Sizing sizing;
+    sizing.min_threads = threads;
+    sizing.max_threads = threads;
+    sizing.lazy_start = true;
+    data = input;
+    start = clock::now();
+    double lazy_ms = 0;
+    {
+        ThreadPool pool(sizing);
+        parallel_merge_sort(pool, data);
+        lazy_ms = ms_since(start);
+    }
+    EXPECT_EQ(data, expected);
+
+    ThreadPool service(threads);
+    start = clock::now();
+    service.warm_up();
+    const double warm_up_ms = ms_since(start);
+    data = input;
+    start = clock::now();
+    parallel_merge_sort(service, data);
+    const double warm_first_ms = ms_since(start);
+    EXPECT_EQ(data, expected);
+    data = input;
+    start = clock::now();
+    parallel_merge_sort(service, data);
+    const double steady_ms = ms_since(start);
+    EXPECT_EQ(data, expected);
+
+    std::cout << "\ntime to first result, 200000 ints, " << threads << " workers: sequential " << sequential_ms
+        << "ms; CLI eager pool " << eager_ms << "ms, lazy pool " << lazy_ms
+        << "ms; service warm_up " << warm_up_ms << "ms then first call " << warm_first_ms
+        << "ms, steady state " << steady_ms << "ms\n";
+}
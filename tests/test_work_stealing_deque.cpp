@@ -0,0 +1,239 @@
+#include <thread_safe_queue/work_stealing_deque.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <optional>
+#include <iostream>
+
+// 测试1：所有者单线程下底部后进先出，从很小的容量开始多次扩容
+TEST(WorkStealingDequeTest, OwnerLifoWithGrowth)
+{
+    WorkStealingDeque<int> deque(2);
+    EXPECT_EQ(deque.capacity(), 2u);
+    EXPECT_FALSE(deque.pop().has_value());
+
+    for (int i = 0; i < 1000; ++i) deque.push(i);
+    EXPECT_EQ(deque.size(), 1000u);
+    EXPECT_GE(deque.capacity(), 1000u);
+
+    for (int i = 999; i >= 0; --i)
+    {
+        auto value = deque.pop();
+        ASSERT_TRUE(value.has_value());
+        ASSERT_EQ(*value, i);
+    }
+    EXPECT_TRUE(deque.empty());
+    EXPECT_FALSE(deque.pop().has_value());
+    EXPECT_FALSE(deque.steal().has_value());
+}
+
+// 测试2：窃取端先进先出，与所有者交替操作同一个双端队列
+TEST(WorkStealingDequeTest, StealTakesOldest)
+{
+    WorkStealingDeque<int> deque(4);
+    for (int i = 0; i < 10; ++i) deque.push(i);
+    EXPECT_EQ(deque.steal(), std::optional<int>(0));
+    EXPECT_EQ(deque.steal(), std::optional<int>(1));
+    EXPECT_EQ(deque.pop(), std::optional<int>(9));
+    deque.push(10);
+    EXPECT_EQ(deque.steal(), std::optional<int>(2));
+    EXPECT_EQ(deque.pop(), std::optional<int>(10));
+    EXPECT_EQ(deque.size(), 6u);
+}
+
+// 测试3：所有者push/pop的同时多个窃取者窃取，并在窃取过程中扩容，每个元素恰好被取走一次
+TEST(WorkStealingDequeTest, ConcurrentStealConservesElements)
+{
+    WorkStealingDeque<int> deque(2);
+    const int items = 200000, thieves = 4;
+    std::vector<std::atomic<int>> seen(items);
+    std::atomic<int> taken{ 0 };
+    std::atomic<bool> done{ false };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thieves; ++i)
+    {
+        threads.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire))
+            {
+                if (auto value = deque.steal())
+                {
+                    seen[*value].fetch_add(1, std::memory_order_relaxed);
+                    taken.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            });
+    }
+
+    // 所有者每推入若干元素弹出一个，制造底部与顶部在少量元素时的竞争
+    for (int i = 0; i < items; ++i)
+    {
+        deque.push(i);
+        if (i % 3 == 0)
+        {
+            if (auto value = deque.pop())
+            {
+                seen[*value].fetch_add(1, std::memory_order_relaxed);
+                taken.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    while (auto value = deque.pop())
+    {
+        seen[*value].fetch_add(1, std::memory_order_relaxed);
+        taken.fetch_add(1, std::memory_order_relaxed);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(taken.load(), items);
+    for (auto& count : seen)
+    {
+        ASSERT_EQ(count.load(), 1);
+    }
+}
+
+// 测试4：反复争抢唯一的元素（所有者pop与窃取者steal同时取最后一个），恰好一方成功
+TEST(WorkStealingDequeTest, LastElementRace)
+{
+    WorkStealingDeque<int> deque;
+    const int rounds = 20000;
+    std::atomic<int> round{ -1 };
+    std::atomic<int> attempted{ -1 };  // 窃取者已尝试过的轮次
+    std::atomic<int> stolen{ 0 };
+    std::atomic<bool> done{ false };
+
+    std::thread thief([&] {
+        int last = -1;
+        while (!done.load(std::memory_order_acquire))
+        {
+            const int r = round.load(std::memory_order_acquire);
+            if (r == last)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            last = r;
+            if (deque.steal()) stolen.fetch_add(1, std::memory_order_relaxed);
+            attempted.store(r, std::memory_order_release);
+        }
+        });
+
+    int popped = 0;
+    for (int r = 0; r < rounds; ++r)
+    {
+        deque.push(r);
+        round.store(r, std::memory_order_release);
+        if (deque.pop()) ++popped;
+        // 等待窃取者完成本轮尝试后再开始下一轮
+        while (attempted.load(std::memory_order_acquire) != r)
+        {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_release);
+    thief.join();
+
+    EXPECT_EQ(popped + stolen.load(), rounds);
+    EXPECT_TRUE(deque.empty());
+}
+
+// 性能测试：一个所有者持续产生任务、多个窃取者窃取，与互斥锁保护的std::deque对比窃取吞吐
+class MutexDeque
+{
+private:
+    std::deque<int> items_;
+    std::mutex mutex_;
+
+public:
+    void push(int value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.push_back(value);
+    }
+    std::optional<int> pop()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty()) return std::nullopt;
+        int value = items_.back();
+        items_.pop_back();
+        return value;
+    }
+    std::optional<int> steal()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty()) return std::nullopt;
+        int value = items_.front();
+        items_.pop_front();
+        return value;
+    }
+};
+
+struct StealBenchmarkResult
+{
+    long long ms;
+    int stolen;
+};
+
+// 所有者每推入8个任务自己弹出1个，其余由窃取者取走
+template <typename Deque>
+StealBenchmarkResult run_steal_benchmark(int thieves, int items)
+{
+    Deque deque;
+    std::atomic<int> taken{ 0 };
+    std::atomic<int> stolen{ 0 };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thieves; ++i)
+    {
+        threads.emplace_back([&] {
+            int local = 0;
+            while (taken.load(std::memory_order_relaxed) < items)
+            {
+                if (deque.steal())
+                {
+                    ++local;
+                    taken.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            stolen.fetch_add(local, std::memory_order_relaxed);
+            });
+    }
+    for (int i = 0; i < items; ++i)
+    {
+        deque.push(i);
+        if (i % 8 == 7 && deque.pop())
+        {
+            taken.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    while (deque.pop())
+    {
+        taken.fetch_add(1, std::memory_order_relaxed);
+    }
+    for (auto& t : threads) t.join();
+
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start
+    ).count();
+    return { ms, stolen.load() };
+}
+
+TEST(WorkStealingDequeTest, StealThroughput)
+{
+    const int items = 2'000'000;
+    std::cout << "\nOne owner, " << items << " tasks:\n";
+    for (int thieves : { 1, 2, 4, 7 })
+    {
+        auto lock_free = run_steal_benchmark<WorkStealingDeque<int>>(thieves, items);
+        auto locked = run_steal_benchmark<MutexDeque>(thieves, items);
+        std::cout << thieves << " thieves - Chase-Lev: " << lock_free.ms << "ms ("
+            << lock_free.stolen << " stolen), mutex deque: " << locked.ms << "ms ("
+            << locked.stolen << " stolen)\n";
+    }
+}